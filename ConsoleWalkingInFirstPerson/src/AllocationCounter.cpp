@@ -0,0 +1,27 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+// every allocation of the process goes through here so the replay can count them per frame
+static std::atomic<long long> _allocationCount(0);
+
+void* operator new(size_t size)
+{
+	_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = malloc(size ? size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+
+long long GetAllocationCount()
+{
+	return _allocationCount.load();
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+// allocations made through operator new since the process started, on every thread
+// the replacement operators live in their own translation unit so the compiler never sees them inlined next to their callers
+long long GetAllocationCount();
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "AnsiTerminal.h"
+
+#ifndef _WIN32
+
+#include <unistd.h>
+#include <errno.h>
+#include <cstdio>
+
+// unchanged cells shorter than this are rewritten rather than jumped over, a cursor move costs up to ~10 bytes
+const int MAX_COALESCED_GAP = 4;
+
+struct Utf8Glyph
+{
+	char Bytes[3];
+	unsigned char Length;
+};
+
+// utf-8 of everything the game draws: ascii and the U+2580 block elements, built once
+class GlyphTable
+{
+public:
+	GlyphTable()
+	{
+		for (int c = 0; c < ASCII_COUNT; c++)
+			_ascii[c] = Encode(c < 0x20 || c == 0x7F ? ' ' : c);
+		for (int c = 0; c < BLOCK_COUNT; c++)
+			_blocks[c] = Encode(BLOCK_FIRST + c);
+	}
+
+	void Append(std::string& out, const wchar_t c) const
+	{
+		const Utf8Glyph& glyph = Find(c);
+		out.append(glyph.Bytes, glyph.Length);
+	}
+
+private:
+	static const int ASCII_COUNT = 128;
+	static const int BLOCK_FIRST = 0x2580;
+	static const int BLOCK_COUNT = 32;
+
+	Utf8Glyph _ascii[ASCII_COUNT];
+	Utf8Glyph _blocks[BLOCK_COUNT];
+
+	const Utf8Glyph& Find(const wchar_t c) const
+	{
+		static const Utf8Glyph REPLACEMENT = Encode('?');
+		if ((unsigned int)c < ASCII_COUNT)
+			return _ascii[c];
+		else if ((unsigned int)(c - BLOCK_FIRST) < BLOCK_COUNT)
+			return _blocks[c - BLOCK_FIRST];
+		else
+			return REPLACEMENT;
+	}
+
+	static Utf8Glyph Encode(const int c)
+	{
+		if (c < 0x80)
+			return { { (char)c }, 1 };
+		else if (c < 0x800)
+			return { { (char)(0xC0 | (c >> 6)), (char)(0x80 | (c & 0x3F)) }, 2 };
+		else
+			return { { (char)(0xE0 | (c >> 12)), (char)(0x80 | ((c >> 6) & 0x3F)), (char)(0x80 | (c & 0x3F)) }, 3 };
+	}
+};
+
+static const GlyphTable GLYPHS;
+
+static void AppendCursorMove(std::string& out, const int x, const int y)
+{
+	char sequence[24];
+	int length = snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", y + 1, x + 1);
+	out.append(sequence, length);
+}
+
+
+AnsiTerminal::AnsiTerminal(const int width, const int height, const int outputFd)
+	:	WIDTH(width), HEIGHT(height), _outputFd(outputFd),
+		_presented((size_t)width * height, ' '), _presentedIsValid(false), _frameBytes(),
+		_restoreInputMode(false), _originalInputMode()
+{
+	if (_outputFd < 0)
+		return;
+
+	// keys should neither echo over the picture nor wait for enter
+	if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &_originalInputMode) == 0)
+	{
+		termios rawMode = _originalInputMode;
+		rawMode.c_lflag &= ~(ICANON | ECHO);
+		rawMode.c_cc[VMIN] = 0;
+		rawMode.c_cc[VTIME] = 0;
+		_restoreInputMode = tcsetattr(STDIN_FILENO, TCSANOW, &rawMode) == 0;
+	}
+
+	_Write(ENTER_SEQUENCE);
+}
+
+AnsiTerminal::~AnsiTerminal()
+{
+	if (_outputFd < 0)
+		return;
+
+	_Write(EXIT_SEQUENCE);
+	if (_restoreInputMode)
+		tcsetattr(STDIN_FILENO, TCSANOW, &_originalInputMode);
+}
+
+void AnsiTerminal::Present(const wchar_t* screen)
+{
+	_frameBytes.clear();
+	EncodeFrame(screen, _frameBytes);
+
+	// the diff assumed the terminal got the last frame, after a lost or cut short write it has to start over
+	if (_outputFd >= 0 && !_frameBytes.empty() && !_Write(_frameBytes))
+		Invalidate();
+}
+
+void AnsiTerminal::EncodeFrame(const wchar_t* screen, std::string& out)
+{
+	for (int y = 0; y < HEIGHT; y++)
+	{
+		const wchar_t* newRow = screen + (size_t)y * WIDTH;
+		wchar_t* oldRow = _presented.data() + (size_t)y * WIDTH;
+
+		// cursor column after the last glyph written in this row, -1 when it is somewhere else
+		int cursorX = -1;
+		int x = 0;
+
+		while (x < WIDTH)
+		{
+			if (_presentedIsValid && newRow[x] == oldRow[x])
+			{
+				x++;
+				continue;
+			}
+
+			// grow the span while the unchanged gaps inside it stay short
+			int spanEnd = x + 1;
+			for (int next = x + 1; next < WIDTH && next - spanEnd < MAX_COALESCED_GAP; next++)
+				if (!_presentedIsValid || newRow[next] != oldRow[next])
+					spanEnd = next + 1;
+
+			if (cursorX != x)
+				AppendCursorMove(out, x, y);
+
+			for (int i = x; i < spanEnd; i++)
+			{
+				GLYPHS.Append(out, newRow[i]);
+				oldRow[i] = newRow[i];
+			}
+
+			// writing the last column leaves the cursor in a pending wrap state
+			cursorX = spanEnd < WIDTH ? spanEnd : -1;
+			x = spanEnd;
+		}
+	}
+
+	_presentedIsValid = true;
+}
+
+void AnsiTerminal::Invalidate()
+{
+	_presentedIsValid = false;
+}
+
+size_t AnsiTerminal::GetLastFrameBytes() const { return _frameBytes.size(); }
+
+bool AnsiTerminal::_Write(const std::string& bytes)
+{
+	size_t written = 0;
+	while (written < bytes.size())
+	{
+		ssize_t result = write(_outputFd, bytes.data() + written, bytes.size() - written);
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0)
+			return false;
+
+		written += (size_t)result;
+	}
+	return true;
+}
+
+std::unique_ptr<Terminal> CreatePlatformTerminal(const int width, const int height)
+{
+	return std::unique_ptr<Terminal>(new AnsiTerminal(width, height, STDOUT_FILENO));
+}
+
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef _WIN32
+
+#include <string>
+#include <vector>
+#include <termios.h>
+
+#include "Terminal.h"
+
+// VT/ANSI output for unix terminals, every frame is diffed against the previous one
+// and only changed spans go out, as one write per frame
+class AnsiTerminal : public Terminal
+{
+public:
+	// alternate screen, hidden cursor, clean slate, and back, written around the game by a terminal with an output
+	static constexpr const char* ENTER_SEQUENCE = "\x1b[?1049h\x1b[?25l\x1b[2J";
+	static constexpr const char* EXIT_SEQUENCE = "\x1b[0m\x1b[?25h\x1b[?1049l";
+
+	// outputFd of -1 keeps the stream in memory only, handy for measuring it headless
+	AnsiTerminal(const int width, const int height, const int outputFd);
+	~AnsiTerminal();
+
+	void Present(const wchar_t* screen) override;
+
+	// appends escape sequences which turn the last encoded frame into screen
+	void EncodeFrame(const wchar_t* screen, std::string& out);
+	// next frame is sent whole, e.g. after something else drew on the terminal
+	void Invalidate();
+
+	size_t GetLastFrameBytes() const;
+
+private:
+	int WIDTH, HEIGHT;
+	int _outputFd;
+
+	std::vector<wchar_t> _presented;
+	bool _presentedIsValid;
+	std::string _frameBytes;
+
+	bool _restoreInputMode;
+	termios _originalInputMode;
+
+	// false when the output failed before every byte went out
+	bool _Write(const std::string& bytes);
+};
+
+#endif
@@ -0,0 +1,851 @@
+#include "Benchmark.h"
+
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <thread>
+
+#include "Vector2.h"
+#include "Maze.h"
+#include "Raycaster.h"
+#include "DistanceField.h"
+#include "FlowField.h"
+#include "Game.h"
+#include "ChunkedWorld.h"
+#include "MazeFile.h"
+#include "MazePool.h"
+#include "InputTrace.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include "GameServer.h"
+#include "WalkerSimulation.h"
+#include "MathUtils.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
+
+static const float BENCH_FOV = PI / 4.0f;
+static const float BENCH_RENDERING_DISTANCE = 16.0f;
+
+struct Pose
+{
+	Vector2f Position;
+	float Angle;
+};
+
+static std::vector<Pose> GenerateEmptyCellPoses(const Maze& maze, int count)
+{
+	const OccupancyGrid& map = maze.GetMap();
+	std::vector<Pose> poses;
+
+	while ((int)poses.size() < count)
+	{
+		int x = rand() % maze.GetMapWidth();
+		int y = rand() % maze.GetMapHeight();
+		if (map.IsWall(x, y))
+			continue;
+
+		float jitterX = (rand() % 100) / 100.0f;
+		float jitterY = (rand() % 100) / 100.0f;
+		float angle = (rand() % 628) / 100.0f;
+		poses.push_back({ { x + jitterX, y + jitterY }, angle });
+	}
+
+	return poses;
+}
+
+static void FillRayDirections(const Pose& pose, int columns, float* directionsX, float* directionsY)
+{
+	for (int x = 0; x < columns; x++)
+	{
+		float rayAngle = (pose.Angle - BENCH_FOV / 2.0f) + ((float)x / (float)columns) * BENCH_FOV;
+		directionsX[x] = cosf(rayAngle);
+		directionsY[x] = sinf(rayAngle);
+	}
+}
+
+// a big hall with scattered pillars, the case empty space skipping is for
+static void RunOpenMapRaycastBenchmark()
+{
+	const int MAP_SIZE = 256;
+	const int PILLAR_SPACING = 24;
+	const int POSE_COUNT = 256;
+	const int COLUMNS = 480;
+	const float RENDERING_DISTANCE = 128.0f;
+	const std::chrono::duration<double> MIN_RUN_TIME(0.25);
+
+	OccupancyGrid grid;
+	grid.Reset(MAP_SIZE, MAP_SIZE, false);
+	for (int i = 0; i < MAP_SIZE; i++)
+	{
+		grid.SetWall(i, 0, true); grid.SetWall(i, MAP_SIZE - 1, true);
+		grid.SetWall(0, i, true); grid.SetWall(MAP_SIZE - 1, i, true);
+	}
+	for (int y = PILLAR_SPACING; y < MAP_SIZE - 2; y += PILLAR_SPACING)
+		for (int x = PILLAR_SPACING; x < MAP_SIZE - 2; x += PILLAR_SPACING)
+			for (int cell = 0; cell < 4; cell++)
+				grid.SetWall(x + cell % 2, y + cell / 2, true);
+
+	auto buildStart = std::chrono::steady_clock::now();
+	DistanceField field;
+	field.Build(grid);
+	std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - buildStart;
+
+	const OccupancyView map = grid.GetView();
+	const DistanceFieldView clearance = field.GetView();
+
+	std::vector<float> directionsX(COLUMNS * POSE_COUNT), directionsY(COLUMNS * POSE_COUNT);
+	std::vector<Vector2f> origins(POSE_COUNT);
+	for (int p = 0; p < POSE_COUNT; )
+	{
+		int x = rand() % MAP_SIZE, y = rand() % MAP_SIZE;
+		if (grid.IsWall(x, y))
+			continue;
+
+		Pose pose { { x + (rand() % 100) / 100.0f, y + (rand() % 100) / 100.0f }, (rand() % 628) / 100.0f };
+		FillRayDirections(pose, COLUMNS, &directionsX[p * COLUMNS], &directionsY[p * COLUMNS]);
+		origins[p++] = pose.Position;
+	}
+
+	printf("\nopen map, %dx%d hall, %d columns, rendering distance %.0f, distance field built in %.2f ms\n",
+		MAP_SIZE, MAP_SIZE, COLUMNS, RENDERING_DISTANCE, buildTime.count());
+	printf("%14s %16s %14s\n", "walk", "columns/sec", "max error");
+
+	std::vector<float> reference(COLUMNS * POSE_COUNT), distances(COLUMNS * POSE_COUNT);
+	for (int p = 0; p < POSE_COUNT; p++)
+		CastRays(map, origins[p], &directionsX[p * COLUMNS], &directionsY[p * COLUMNS],
+			COLUMNS, RENDERING_DISTANCE, &reference[p * COLUMNS], RaycastKernel::Scalar);
+
+	for (int walk = 0; walk < 3; walk++)
+	{
+		const char* name = walk == 0 ? "every cell" : (walk == 1 ? GetRaycastKernelName(GetBestRaycastKernel()) : "distance field");
+
+		long long castColumns = 0;
+		auto start = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed(0.0);
+		while (elapsed < MIN_RUN_TIME)
+		{
+			for (int p = 0; p < POSE_COUNT; p++)
+			{
+				const float* dirX = &directionsX[p * COLUMNS];
+				const float* dirY = &directionsY[p * COLUMNS];
+				if (walk == 0)
+					CastRays(map, origins[p], dirX, dirY, COLUMNS, RENDERING_DISTANCE, &distances[p * COLUMNS], RaycastKernel::Scalar);
+				else if (walk == 1)
+					CastRays(map, origins[p], dirX, dirY, COLUMNS, RENDERING_DISTANCE, &distances[p * COLUMNS]);
+				else
+					CastRays(map, clearance, origins[p], dirX, dirY, COLUMNS, RENDERING_DISTANCE, &distances[p * COLUMNS]);
+			}
+			castColumns += (long long)COLUMNS * POSE_COUNT;
+			elapsed = std::chrono::steady_clock::now() - start;
+		}
+
+		float maxError = 0.0f;
+		for (size_t i = 0; i < reference.size(); i++)
+			maxError = std::max(maxError, std::fabs(reference[i] - distances[i]));
+		printf("%14s %16.0f %14g\n", name, castColumns / elapsed.count(), maxError);
+	}
+}
+
+void RunRaycastBenchmark()
+{
+	const int MAZE_SIZE = 24;
+	const int POSE_COUNT = 256;
+	const int COLUMN_WIDTHS[] = { 120, 480, 1920 };
+	const RaycastKernel KERNELS[] = { RaycastKernel::Scalar, RaycastKernel::Sse2, RaycastKernel::Avx2 };
+	const std::chrono::duration<double> MIN_RUN_TIME(0.25);
+
+	srand(1);
+	Maze maze;
+	maze.Generate(MAZE_SIZE, MAZE_SIZE);
+	const OccupancyView map = maze.GetMap().GetView();
+	const Vector2n mapDim { maze.GetMapWidth(), maze.GetMapHeight() };
+	const std::vector<Pose> poses = GenerateEmptyCellPoses(maze, POSE_COUNT);
+
+	printf("raycast benchmark, %dx%d map, %d poses, best kernel: %s\n",
+		mapDim.X, mapDim.Y, POSE_COUNT, GetRaycastKernelName(GetBestRaycastKernel()));
+	printf("%8s %8s %16s %10s\n", "columns", "kernel", "columns/sec", "output");
+
+	for (int columns : COLUMN_WIDTHS)
+	{
+		std::vector<float> directionsX(columns * POSE_COUNT), directionsY(columns * POSE_COUNT);
+		for (int p = 0; p < POSE_COUNT; p++)
+			FillRayDirections(poses[p], columns, &directionsX[p * columns], &directionsY[p * columns]);
+
+		std::vector<float> reference(columns * POSE_COUNT), distances(columns * POSE_COUNT);
+		for (int p = 0; p < POSE_COUNT; p++)
+			CastRays(map, poses[p].Position, &directionsX[p * columns], &directionsY[p * columns],
+				columns, BENCH_RENDERING_DISTANCE, &reference[p * columns], RaycastKernel::Scalar);
+
+		for (RaycastKernel kernel : KERNELS)
+		{
+			if (!IsRaycastKernelSupported(kernel))
+			{
+				printf("%8d %8s %16s %10s\n", columns, GetRaycastKernelName(kernel), "-", "unsupported");
+				continue;
+			}
+
+			long long castColumns = 0;
+			auto start = std::chrono::steady_clock::now();
+			std::chrono::duration<double> elapsed(0.0);
+			while (elapsed < MIN_RUN_TIME)
+			{
+				for (int p = 0; p < POSE_COUNT; p++)
+					CastRays(map, poses[p].Position, &directionsX[p * columns], &directionsY[p * columns],
+						columns, BENCH_RENDERING_DISTANCE, &distances[p * columns], kernel);
+				castColumns += (long long)columns * POSE_COUNT;
+				elapsed = std::chrono::steady_clock::now() - start;
+			}
+
+			bool identical = memcmp(reference.data(), distances.data(), reference.size() * sizeof(float)) == 0;
+			printf("%8d %8s %16.0f %10s\n", columns, GetRaycastKernelName(kernel),
+				castColumns / elapsed.count(), identical ? "identical" : "MISMATCH");
+		}
+	}
+
+	RunOpenMapRaycastBenchmark();
+}
+
+// takes rows and drops them, what is left to time is the generator itself
+class DiscardRowSink : public MazeRowSink
+{
+public:
+	void Begin(const int /*mapWidth*/, const int /*mapHeight*/) override {}
+	bool WriteRow(const int /*mapY*/, const char* /*row*/) override { return true; }
+};
+
+void RunMazeBenchmark()
+{
+	const int MAZE_SIZES[] = { 64, 256, 1024, 2048, 4096 };
+	// taller than any in-memory map would comfortably be, only the streamed generator runs it
+	const Vector2n TALL_MAZE { 256, 1 << 16 };
+	// big enough for every core to get many tiles, generated once per thread count
+	const Vector2n SCALING_MAZE { 10000, 10000 };
+	const std::chrono::duration<double> MIN_RUN_TIME(0.25);
+
+	srand(1);
+	Maze maze;
+	DiscardRowSink discardSink;
+	// timed on its own, the generator rows are generation alone
+	maze.SetFlowFieldEnabled(false);
+	FlowField flowField;
+	// one thread per core
+	ThreadPool tilePool(0);
+
+	printf("maze generation benchmark\n");
+	printf("%15s %16s %12s %16s\n", "maze", "generator", "ms/maze", "cells/sec");
+
+	auto runTimed = [&](const char* generator, int width, int height, auto&& generate)
+	{
+		// first generation sizes the scratch buffers, the timed ones reuse them
+		generate();
+
+		int generations = 0;
+		auto start = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed(0.0);
+		while (elapsed < MIN_RUN_TIME)
+		{
+			generate();
+			generations++;
+			elapsed = std::chrono::steady_clock::now() - start;
+		}
+
+		double cells = (double)width * height * generations;
+		printf("%7dx%-7d %16s %12.2f %16.0f\n", width, height, generator, elapsed.count() * 1000.0 / generations, cells / elapsed.count());
+	};
+
+	for (int size : MAZE_SIZES)
+	{
+		maze.SetAlgorithm(MazeAlgorithm::DepthFirst);
+		runTimed("depth first", size, size, [&] { maze.Generate(size, size); });
+		const Vector2n exitPos = maze.GetExitPos();
+		runTimed("exit flow field", size, size, [&] { flowField.Build(maze.GetMap(), &exitPos, 1); });
+		maze.SetAlgorithm(MazeAlgorithm::Eller);
+		runTimed("eller", size, size, [&] { maze.Generate(size, size); });
+		runTimed("eller streamed", size, size, [&] { maze.GenerateRows(size, size, discardSink); });
+		runTimed("tiled", size, size, [&] { maze.GenerateTiled(size, size, 1, Maze::DEFAULT_TILE_SIZE, &tilePool); });
+	}
+
+	runTimed("eller streamed", TALL_MAZE.X, TALL_MAZE.Y, [&] { maze.GenerateRows(TALL_MAZE.X, TALL_MAZE.Y, discardSink); });
+
+	// the same maze whatever the thread count, only the time changes
+	printf("tiled scaling, %dx%d maze, %dx%d tiles\n", SCALING_MAZE.X, SCALING_MAZE.Y, Maze::DEFAULT_TILE_SIZE, Maze::DEFAULT_TILE_SIZE);
+	printf("%8s %12s %16s %10s\n", "threads", "ms/maze", "cells/sec", "speedup");
+	double singleThreadMs = 0.0;
+	for (int threads = 1; threads <= std::max(4, tilePool.GetThreadCount()); threads *= 2)
+	{
+		ThreadPool pool(threads);
+		auto start = std::chrono::steady_clock::now();
+		maze.GenerateTiled(SCALING_MAZE.X, SCALING_MAZE.Y, 1, Maze::DEFAULT_TILE_SIZE, &pool);
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (threads == 1)
+			singleThreadMs = elapsedMs;
+
+		printf("%8d %12.2f %16.0f %9.2fx\n", threads, elapsedMs, (double)SCALING_MAZE.X * SCALING_MAZE.Y / (elapsedMs / 1000.0), singleThreadMs / elapsedMs);
+	}
+}
+
+
+static const float REPLAY_TIMESTEP = 1.0f / 60.0f;
+// bottom rows the debug overlay fills with timings, the frame checksum skips them
+#if PROFILER_ENABLED
+static const int REPLAY_TIMING_ROWS = 1 + FRAME_STAGE_COUNT;
+#else
+static const int REPLAY_TIMING_ROWS = 1;
+#endif
+// how much slower than the baseline a run may get before it counts as a regression
+static const double REPLAY_TIME_TOLERANCE = 1.25;
+
+// walks, turns, strafes and opens both overlays, about 10 seconds at 60 fps
+static const char* DEFAULT_REPLAY_TRACE =
+	"60 W\n"
+	"45 RIGHT\n"
+	"60 W\n"
+	"1 M\n"
+	"90 LEFT\n"
+	"60 W D\n"
+	"1 DELETE\n"
+	"60 S A\n"
+	"120 W RIGHT\n"
+	"1 M\n"
+	"60 LEFT\n"
+	"60\n";
+
+struct ReplayResult
+{
+	double P50Ms;
+	double P95Ms;
+	double P99Ms;
+	double ColumnsPerSecond;
+	double AllocationsPerFrame;
+	unsigned long long FrameChecksum;
+};
+
+static double GetPercentile(const std::vector<double>& sortedValues, double percentile)
+{
+	size_t index = (size_t)(percentile / 100.0 * (sortedValues.size() - 1) + 0.5);
+	return sortedValues[std::min(index, sortedValues.size() - 1)];
+}
+
+static bool LoadReplayBaseline(const char* path, ReplayResult& baseline)
+{
+	std::ifstream file(path);
+	if (!file)
+		return false;
+
+	std::map<std::string, double> values;
+	std::string key;
+	unsigned long long checksum = 0;
+	while (file >> key)
+	{
+		if (key == "checksum")
+			file >> std::hex >> checksum >> std::dec;
+		else
+			file >> values[key];
+	}
+
+	baseline = { values["p50_ms"], values["p95_ms"], values["p99_ms"], values["columns_per_sec"], values["allocations_per_frame"], checksum };
+	return true;
+}
+
+static bool SaveReplayBaseline(const char* path, const ReplayResult& result)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "p50_ms %.4f\np95_ms %.4f\np99_ms %.4f\ncolumns_per_sec %.0f\nallocations_per_frame %.3f\nchecksum %llx\n",
+		result.P50Ms, result.P95Ms, result.P99Ms, result.ColumnsPerSecond, result.AllocationsPerFrame, result.FrameChecksum);
+	fclose(file);
+	return true;
+}
+
+int RunReplayBenchmark(const ReplayBenchmarkOptions& options)
+{
+	std::vector<InputTraceSegment> trace;
+	bool traceLoaded = options.TracePath
+		? LoadInputTrace(options.TracePath, trace)
+		: ParseInputTrace(DEFAULT_REPLAY_TRACE, trace);
+	if (!traceLoaded)
+	{
+		fprintf(stderr, "could not read input trace %s\n", options.TracePath);
+		return 2;
+	}
+
+	srand(options.Seed);
+	Maze maze;
+	std::unique_ptr<ChunkedWorld> chunks(options.InfiniteWorld ? new ChunkedWorld() : nullptr);
+	GameWorld world;
+	PlayerState player;
+	if (chunks)
+		GameInitChunked(*chunks, options.Seed, world);
+	else
+	{
+		GenerateMaze(maze, MAZE_DIMENSIONS, options.Seed);
+		GameInit(maze, world);
+	}
+	PlayerInit(world, player);
+
+	ThreadPool renderPool(options.RenderThreadCount);
+	RenderBuffers buffers;
+	buffers.RenderColumns = options.RenderColumns;
+	std::vector<wchar_t> screen((size_t)SCREEN_DIMENSIONS.X * SCREEN_DIMENSIONS.Y, ' ');
+
+	const int frameCount = GetTraceFrameCount(trace);
+	std::vector<double> frameTimesMs;
+	frameTimesMs.reserve(frameCount);
+
+	// one warm-up frame sizes the render buffers, it is not part of the numbers
+	WriteFrame(screen.data(), renderPool, buffers, world, player, REPLAY_TIMESTEP, 0.0f);
+
+	unsigned long long checksum = 14695981039346656037ull;
+	long long allocationsBefore = GetAllocationCount();
+
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		{
+			PROFILE_STAGE(FrameStage::Input);
+			HandleInput(world, player, GetTraceInput(trace, frame), REPLAY_TIMESTEP);
+			if (chunks)
+				UpdateChunkedWorld(*chunks, world, player);
+		}
+		WriteFrame(screen.data(), renderPool, buffers, world, player, REPLAY_TIMESTEP, 0.0f);
+
+		std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - start;
+		frameTimesMs.push_back(frameTime.count());
+
+		// FNV-1a over every frame, the debug line and the profiler stats above it show timings so they are left out
+		for (int i = 0; i < SCREEN_DIMENSIONS.X * (SCREEN_DIMENSIONS.Y - REPLAY_TIMING_ROWS); i++)
+			checksum = (checksum ^ (unsigned long long)screen[i]) * 1099511628211ull;
+	}
+
+	long long allocations = GetAllocationCount() - allocationsBefore;
+
+	double totalMs = 0.0;
+	for (double frameTime : frameTimesMs)
+		totalMs += frameTime;
+	std::sort(frameTimesMs.begin(), frameTimesMs.end());
+
+	ReplayResult result
+	{
+		GetPercentile(frameTimesMs, 50.0), GetPercentile(frameTimesMs, 95.0), GetPercentile(frameTimesMs, 99.0),
+		(double)frameCount * SCREEN_DIMENSIONS.X / (totalMs / 1000.0),
+		(double)allocations / frameCount,
+		checksum
+	};
+
+	printf("replay benchmark, seed %u, %d frames, %dx%d screen, %d render threads\n",
+		options.Seed, frameCount, SCREEN_DIMENSIONS.X, SCREEN_DIMENSIONS.Y, renderPool.GetThreadCount());
+	printf("frame time   p50 %.4f ms   p95 %.4f ms   p99 %.4f ms\n", result.P50Ms, result.P95Ms, result.P99Ms);
+	printf("columns/sec  %.0f\n", result.ColumnsPerSecond);
+	printf("allocations  %.3f per frame\n", result.AllocationsPerFrame);
+	printf("checksum     %llx\n", result.FrameChecksum);
+
+	int exitCode = 0;
+	ReplayResult baseline;
+	if (options.BaselinePath && LoadReplayBaseline(options.BaselinePath, baseline))
+	{
+		if (result.FrameChecksum != baseline.FrameChecksum)
+		{
+			printf("REGRESSION: rendered frames differ from the baseline (%llx)\n", baseline.FrameChecksum);
+			exitCode = 1;
+		}
+		if (result.P95Ms > baseline.P95Ms * REPLAY_TIME_TOLERANCE)
+		{
+			printf("REGRESSION: p95 frame time %.4f ms, baseline %.4f ms\n", result.P95Ms, baseline.P95Ms);
+			exitCode = 1;
+		}
+		if (result.AllocationsPerFrame > baseline.AllocationsPerFrame)
+		{
+			printf("REGRESSION: %.3f allocations per frame, baseline %.3f\n", result.AllocationsPerFrame, baseline.AllocationsPerFrame);
+			exitCode = 1;
+		}
+		if (exitCode == 0)
+			printf("baseline     ok\n");
+	}
+	else if (options.BaselinePath)
+	{
+		printf("baseline     %s not found\n", options.BaselinePath);
+	}
+
+	if (options.SaveBaselinePath && !SaveReplayBaseline(options.SaveBaselinePath, result))
+	{
+		fprintf(stderr, "could not write baseline %s\n", options.SaveBaselinePath);
+		return 2;
+	}
+
+	return exitCode;
+}
+
+void RunChunkBenchmark()
+{
+	const int WALK_CHUNKS = 4096;
+	const unsigned int SEED = 1;
+
+	ChunkedWorld chunks;
+	chunks.Reset(SEED);
+
+	std::vector<double> recenterTimesMs;
+	recenterTimesMs.reserve(WALK_CHUNKS);
+
+	// one cell at a time like a player would, give the generator a frame's worth of time between chunks
+	for (int x = 0; x < WALK_CHUNKS * ChunkedWorld::CHUNK_SIZE; x++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		bool moved = chunks.Recenter(x, 1);
+		std::chrono::duration<double, std::milli> recenterTime = std::chrono::steady_clock::now() - start;
+
+		if (moved)
+		{
+			recenterTimesMs.push_back(recenterTime.count());
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	std::sort(recenterTimesMs.begin(), recenterTimesMs.end());
+	printf("chunked world benchmark, walked %d chunks of %dx%d cells\n", WALK_CHUNKS, ChunkedWorld::CHUNK_SIZE, ChunkedWorld::CHUNK_SIZE);
+	printf("window move  p50 %.4f ms   p99 %.4f ms   max %.4f ms\n",
+		GetPercentile(recenterTimesMs, 50.0), GetPercentile(recenterTimesMs, 99.0), recenterTimesMs.back());
+	printf("cached       %d chunks, %zu bytes in total\n", chunks.GetCachedChunkCount(), chunks.GetMemoryBytes());
+}
+
+int RunMazeFileBenchmark(const char* path)
+{
+	const int OPEN_RUNS = 16;
+	const int COLUMNS = 120;
+
+	auto start = std::chrono::steady_clock::now();
+	MazeFile file;
+	if (!file.Open(path))
+	{
+		fprintf(stderr, "could not open maze file %s\n", path);
+		return 2;
+	}
+	std::chrono::duration<double, std::milli> firstOpenTime = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < OPEN_RUNS; i++)
+	{
+		MazeFile reopened;
+		reopened.Open(path);
+	}
+	std::chrono::duration<double, std::milli> openTime = (std::chrono::steady_clock::now() - start) / OPEN_RUNS;
+
+	// one frame's rays from the start, the pages they touch are all that gets read in
+	const MazeFileContents& contents = file.GetContents();
+	const Pose pose { Vector2f(contents.StartPos) + Vector2f(0.5f, 0.5f), 0.0f };
+	std::vector<float> directionsX(COLUMNS), directionsY(COLUMNS), distances(COLUMNS);
+	FillRayDirections(pose, COLUMNS, directionsX.data(), directionsY.data());
+
+	start = std::chrono::steady_clock::now();
+	CastRays(contents.Map, pose.Position, directionsX.data(), directionsY.data(), COLUMNS, BENCH_RENDERING_DISTANCE, distances.data(), GetBestRaycastKernel());
+	std::chrono::duration<double, std::milli> firstFrameTime = std::chrono::steady_clock::now() - start;
+
+	Maze maze;
+	start = std::chrono::steady_clock::now();
+	maze.Load(path);
+	std::chrono::duration<double, std::milli> loadTime = std::chrono::steady_clock::now() - start;
+
+	printf("maze file benchmark, %s, %zu bytes\n", path, file.GetFileBytes());
+	printf("maze         %dx%d, %dx%d map, %.0f map cells, sections:%s%s\n", contents.MazeWidth, contents.MazeHeight,
+		contents.Map.Width, contents.Map.Height, (double)contents.Map.Width * contents.Map.Height,
+		contents.Clearance.Clearance ? " distance field" : "", contents.PathToExit.Cells ? " flow field" : "");
+	printf("first open   %.3f ms\n", firstOpenTime.count());
+	printf("open         %.3f ms\n", openTime.count());
+	printf("first frame  %.3f ms, %d rays from the start\n", firstFrameTime.count(), COLUMNS);
+	printf("Maze::Load   %.3f ms, copies the file into the maze\n", loadTime.count());
+	return 0;
+}
+
+void RunMazePoolBenchmark()
+{
+	// big enough that generating in place is a visible stall
+	const Vector2n POOL_MAZE_DIMENSIONS { 512, 512 };
+	const int RESTARTS = 16;
+	const int POOL_CAPACITY = 2;
+	// how long each game lasts, the last run restarts right away so the pool cannot keep up
+	const int PLAY_TIMES_MS[] = { 250, 50, 0 };
+
+	auto generate = [&](Maze& maze, unsigned int seed) { GenerateMaze(maze, POOL_MAZE_DIMENSIONS, seed); };
+
+	printf("maze pool benchmark, %dx%d mazes, %d restarts, pool of %d\n", POOL_MAZE_DIMENSIONS.X, POOL_MAZE_DIMENSIONS.Y, RESTARTS, POOL_CAPACITY);
+	printf("%10s %12s %14s %14s %10s %10s\n", "play ms", "source", "avg restart", "max restart", "waited", "avg ready");
+
+	{
+		Maze maze;
+		std::vector<double> restartTimesMs;
+		for (int i = 0; i < RESTARTS; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			generate(maze, (unsigned int)i);
+			restartTimesMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(restartTimesMs.begin(), restartTimesMs.end());
+		double totalMs = 0.0;
+		for (double time : restartTimesMs)
+			totalMs += time;
+		printf("%10s %12s %11.3f ms %11.3f ms %10s %10s\n", "-", "in place", totalMs / RESTARTS, restartTimesMs.back(), "-", "-");
+	}
+
+	for (int playTimeMs : PLAY_TIMES_MS)
+	{
+		MazePool pool(POOL_CAPACITY, 1, generate);
+		std::unique_ptr<Maze> maze;
+		std::vector<double> restartTimesMs;
+		int readyTotal = 0;
+
+		for (int i = 0; i < RESTARTS; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(playTimeMs));
+
+			readyTotal += pool.GetStats().ReadyCount;
+			auto start = std::chrono::steady_clock::now();
+			std::unique_ptr<Maze> nextMaze = pool.Pop();
+			restartTimesMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+			pool.Recycle(std::move(maze));
+			maze = std::move(nextMaze);
+		}
+
+		MazePoolStats stats = pool.GetStats();
+		std::sort(restartTimesMs.begin(), restartTimesMs.end());
+		double totalMs = 0.0;
+		for (double time : restartTimesMs)
+			totalMs += time;
+		printf("%10d %12s %11.3f ms %11.3f ms %4d of %2d %10.2f\n", playTimeMs, "pool", totalMs / RESTARTS, restartTimesMs.back(),
+			stats.WaitedPopCount, stats.PopCount, (double)readyTotal / RESTARTS);
+	}
+}
+
+void RunWalkerBenchmark(const int threadCount)
+{
+	const Vector2n WALKER_MAZE_DIMENSIONS { 16, 16 };
+	const int WALKERS_PER_POLICY = 2048;
+	const float TIME_STEP = 1.0f / 60.0f;
+	// ten minutes of walking, long enough for either hand of a wall follower to find the way out
+	const int TICKS = 10 * 60 * 60;
+	const char* POLICY_NAMES[WALKER_POLICY_COUNT] = { "wall follower", "random walk" };
+
+	Maze maze;
+	GenerateMaze(maze, WALKER_MAZE_DIMENSIONS, 1);
+	GameWorld world;
+	GameInit(maze, world);
+	ThreadPool pool(threadCount);
+
+	WalkerSimulation simulation(world, pool, TIME_STEP);
+	for (int policy = 0; policy < WALKER_POLICY_COUNT; policy++)
+		simulation.AddWalkers(WALKERS_PER_POLICY, (WalkerPolicy)policy, (unsigned int)policy + 1);
+
+	std::vector<double> tickTimesMs;
+	tickTimesMs.reserve(TICKS);
+	auto start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < TICKS; tick++)
+	{
+		auto tickStart = std::chrono::steady_clock::now();
+		simulation.Step();
+		tickTimesMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickStart).count());
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::sort(tickTimesMs.begin(), tickTimesMs.end());
+	printf("walker simulation, %d walkers, %dx%d maze, %d ticks of %.1f ms, %d threads\n", simulation.GetWalkerCount(),
+		WALKER_MAZE_DIMENSIONS.X, WALKER_MAZE_DIMENSIONS.Y, TICKS, TIME_STEP * 1000.0f, pool.GetThreadCount());
+	printf("throughput   %.0f walker steps/sec\n", (double)simulation.GetWalkerCount() * TICKS / seconds);
+	printf("tick         p50 %.4f ms   p99 %.4f ms   max %.4f ms\n",
+		GetPercentile(tickTimesMs, 50.0), GetPercentile(tickTimesMs, 99.0), tickTimesMs.back());
+
+	printf("time to exit, in walked seconds\n");
+	printf("%14s %8s %9s %9s %9s %9s %9s %12s\n", "policy", "exits", "p10", "p50", "p90", "p99", "max", "never out");
+	for (int policy = 0; policy < WALKER_POLICY_COUNT; policy++)
+	{
+		std::vector<double> exitSeconds;
+		for (int ticks : simulation.GetExitTicks((WalkerPolicy)policy))
+			exitSeconds.push_back(ticks * TIME_STEP);
+		std::sort(exitSeconds.begin(), exitSeconds.end());
+
+		const int unfinished = simulation.GetUnfinishedCount((WalkerPolicy)policy);
+		if (exitSeconds.empty())
+		{
+			printf("%14s %8d %9s %9s %9s %9s %9s %12d\n", POLICY_NAMES[policy], 0, "-", "-", "-", "-", "-", unfinished);
+			continue;
+		}
+
+		printf("%14s %8zu %9.1f %9.1f %9.1f %9.1f %9.1f %12d\n", POLICY_NAMES[policy], exitSeconds.size(),
+			GetPercentile(exitSeconds, 10.0), GetPercentile(exitSeconds, 50.0), GetPercentile(exitSeconds, 90.0),
+			GetPercentile(exitSeconds, 99.0), exitSeconds.back(), unfinished);
+	}
+}
+
+#ifndef _WIN32
+
+// resident memory of the whole process, 0 where it cannot be read
+static long long GetResidentBytes()
+{
+	FILE* statm = fopen("/proc/self/statm", "r");
+	if (!statm)
+		return 0;
+
+	long long pages = 0, residentPages = 0;
+	if (fscanf(statm, "%lld %lld", &pages, &residentPages) != 2)
+		residentPages = 0;
+	fclose(statm);
+	return residentPages * sysconf(_SC_PAGESIZE);
+}
+
+// the far ends of sessionCount connections handed to the server
+static std::vector<int> ConnectClients(GameServer& server, const int sessionCount)
+{
+	std::vector<int> clients;
+	for (int i = 0; i < sessionCount; i++)
+	{
+		int fds[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+			break;
+
+		fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL, 0) | O_NONBLOCK);
+		server.AddConnection(fds[0]);
+		clients.push_back(fds[1]);
+	}
+	return clients;
+}
+
+// every client keeps turning while it walks forwards and back, so nearly every frame moves and is cast in full and a wall
+// in the way only stops a client until it backs off,
+// enter starts a player over should one find the exit, all output is read and thrown away
+static void RunClients(const std::vector<int>& clients, const std::chrono::milliseconds duration)
+{
+	// under the key hold time, so the walk never stops
+	const std::chrono::milliseconds KEY_INTERVAL(50);
+
+	std::vector<pollfd> pollFds(clients.size());
+	char drain[1 << 16];
+
+	const auto end = std::chrono::steady_clock::now() + duration;
+	auto nextKeys = std::chrono::steady_clock::now();
+	for (int step = 0; std::chrono::steady_clock::now() < end; )
+	{
+		if (std::chrono::steady_clock::now() >= nextKeys)
+		{
+			const char* KEYS[] = { "w\r\x1b[C", "s\r\x1b[C", "w\r\x1b[D", "s\r\x1b[D" };
+			for (size_t i = 0; i < clients.size(); i++)
+			{
+				const char* keys = KEYS[(step + i) / 8 % 4];
+				send(clients[i], keys, strlen(keys), MSG_NOSIGNAL);
+			}
+			step++;
+			nextKeys += KEY_INTERVAL;
+		}
+
+		for (size_t i = 0; i < clients.size(); i++)
+			pollFds[i] = { clients[i], POLLIN, 0 };
+		auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(std::min(nextKeys, end) - std::chrono::steady_clock::now());
+		if (poll(pollFds.data(), (nfds_t)pollFds.size(), std::max(0, (int)wait.count())) <= 0)
+			continue;
+
+		for (const pollfd& client : pollFds)
+			if (client.revents)
+				while (recv(client.fd, drain, sizeof(drain), MSG_DONTWAIT) > 0) {}
+	}
+}
+
+static void CloseClients(const std::vector<int>& clients)
+{
+	for (int fd : clients)
+		close(fd);
+}
+
+#endif
+
+void RunServerBenchmark(const int threadCount)
+{
+#ifdef _WIN32
+	printf("the server needs unix sockets, there is nothing to load test on this platform\n");
+#else
+	const int TARGET_FPS = 30;
+	const int MAX_SESSIONS = 4096;
+	// sessions the memory is measured with, enough to drown out whatever else the process allocates
+	const int MEMORY_SESSIONS = 256;
+	const std::chrono::milliseconds WARM_UP_TIME(500);
+	const std::chrono::milliseconds MEASURE_TIME(2000);
+	// a run that kept this share of the target still counts as keeping up
+	const double FPS_TOLERANCE = 0.95;
+
+	Maze maze;
+	GenerateMaze(maze, SERVER_MAZE_DIMENSIONS, 1);
+	GameWorld world;
+	GameInit(maze, world);
+	ThreadPool pool(threadCount);
+
+	printf("server load test, %d fps, %d threads, %dx%d screens, %dx%d maze\n", TARGET_FPS, pool.GetThreadCount(),
+		SCREEN_DIMENSIONS.X, SCREEN_DIMENSIONS.Y, SERVER_MAZE_DIMENSIONS.X, SERVER_MAZE_DIMENSIONS.Y);
+
+	// first, while the heap has not been grown by anything else
+	double sessionBytes = 0.0;
+	{
+		GameServer server(world, pool, TARGET_FPS, 0);
+		const long long residentBefore = GetResidentBytes();
+		std::vector<int> clients = ConnectClients(server, MEMORY_SESSIONS);
+		std::thread serverThread([&server] { server.Run(); });
+
+		RunClients(clients, WARM_UP_TIME);
+		sessionBytes = (double)(GetResidentBytes() - residentBefore) / clients.size();
+
+		server.Stop();
+		serverThread.join();
+		CloseClients(clients);
+	}
+
+	printf("%9s %9s %12s %12s %16s %12s\n", "sessions", "fps", "avg tick", "max tick", "core ms/frame", "KB/s each");
+
+	double sessionsPerCore = 0.0;
+	for (int sessionCount = 1; sessionCount <= MAX_SESSIONS; sessionCount *= 2)
+	{
+		GameServer server(world, pool, TARGET_FPS, 0);
+		std::vector<int> clients = ConnectClients(server, sessionCount);
+		std::thread serverThread([&server] { server.Run(); });
+
+		RunClients(clients, WARM_UP_TIME);
+		server.ResetStats();
+		auto start = std::chrono::steady_clock::now();
+		RunClients(clients, MEASURE_TIME);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		GameServerStats stats = server.GetStats();
+
+		server.Stop();
+		serverThread.join();
+		CloseClients(clients);
+
+		const double fps = stats.FramesSent / (double)clients.size() / seconds;
+		const double avgTickMs = stats.TickCount > 0 ? stats.TotalTickMs / stats.TickCount : 0.0;
+		// as if every thread was busy for the whole tick
+		const double coreMsPerFrame = avgTickMs * pool.GetThreadCount() / clients.size();
+		printf("%9zu %9.1f %9.3f ms %9.3f ms %13.4f ms %12.1f\n", clients.size(), fps, avgTickMs, stats.MaxTickMs, coreMsPerFrame,
+			stats.BytesSent / 1024.0 / clients.size() / seconds);
+
+		if (fps < TARGET_FPS * FPS_TOLERANCE || (int)clients.size() < sessionCount)
+			break;
+		// the biggest run that kept up, the per-frame cost of everything but the sessions is spread the thinnest there
+		sessionsPerCore = 1000.0 / TARGET_FPS / coreMsPerFrame;
+	}
+
+	printf("sessions per core at %d fps  %.1f\n", TARGET_FPS, sessionsPerCore);
+	if (sessionBytes > 0.0)
+		printf("memory per session           %.1f KB resident, socket buffers live in the kernel and are not counted\n", sessionBytes / 1024.0);
+	else
+		printf("memory per session           unknown, /proc/self/statm cannot be read\n");
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+// console-less benchmarks, started from the command line
+void RunRaycastBenchmark();
+void RunMazeBenchmark();
+// walks a straight line through the chunked world, reports how long moving the window takes and what it keeps in memory
+void RunChunkBenchmark();
+// restarts a game over and over, how long getting the next maze takes from a MazePool against generating it in place
+void RunMazePoolBenchmark();
+// load test of the multi-player server, clients in this process walk over socket pairs at 30 fps
+// until the server cannot keep up, reports sessions per core and memory per session
+void RunServerBenchmark(const int threadCount);
+// thousands of bot walkers of every policy through one maze with nothing rendered, throughput of the movement,
+// collision and progress code, reports walker steps per second, tick times and how long the walkers took to the exit
+void RunWalkerBenchmark(const int threadCount);
+// opens a --save-maze file, times mapping it and the first rays cast from it against copying it into a Maze,
+// returns the process exit code
+int RunMazeFileBenchmark(const char* path);
+
+struct ReplayBenchmarkOptions
+{
+	unsigned int Seed;
+	// nullptr - built-in walk
+	const char* TracePath;
+	// numbers this run is compared against, nullptr - no comparison
+	const char* BaselinePath;
+	// where this run's numbers are stored as the new baseline, nullptr - nowhere
+	const char* SaveBaselinePath;
+	int RenderThreadCount;
+	// rays cast per frame, 0 - one per column
+	int RenderColumns;
+	// chunked world seeded from Seed instead of a maze
+	bool InfiniteWorld;
+};
+
+// replays an input trace at a fixed timestep and renders off-screen,
+// returns the process exit code, non-zero when the run regressed against the baseline
+int RunReplayBenchmark(const ReplayBenchmarkOptions& options);
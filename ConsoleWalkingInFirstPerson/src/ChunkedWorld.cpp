@@ -0,0 +1,221 @@
+#include "ChunkedWorld.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "MathUtils.h"
+
+// separate hash streams of a chunk, one seeds its maze and one places its border openings
+const unsigned int CHUNK_MAZE_SALT = 0x6D617A65u;
+const unsigned int CHUNK_DOOR_SALT = 0x646F6F72u;
+
+// openings per owned border, more than one keeps the world from being a tree across chunk lines
+const int CHUNK_DOORS_PER_BORDER = 2;
+
+// everything that identifies a chunk hashed together, neighbouring coordinates give unrelated numbers
+static unsigned int HashChunk(const unsigned int seed, const Vector2n& coord, const unsigned int salt)
+{
+	return MixHash(seed * 0x9E3779B97F4A7C15ull
+		^ (unsigned int)coord.X * 0xC2B2AE3D27D4EB4Full
+		^ (unsigned int)coord.Y * 0x165667B19E3779F9ull
+		^ salt);
+}
+
+// rounds towards negative infinity, chunk -1 holds cells -CHUNK_SIZE to -1
+static int FloorDiv(const int value, const int divisor)
+{
+	return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+
+ChunkedWorld::ChunkedWorld()
+	:	_seed(0), _center(), _window(), _cache(), _useCounter(0), _cacheMutex(),
+		_pending(), _wakeUp(), _stopping(false), _generator(),
+		_generatorMaze(), _fallbackMaze()
+{
+	_window.Reset(CHUNK_SIZE * WINDOW_CHUNKS, CHUNK_SIZE * WINDOW_CHUNKS, true);
+	_generator = std::thread(&ChunkedWorld::_GeneratorLoop, this);
+}
+
+ChunkedWorld::~ChunkedWorld()
+{
+	{
+		std::lock_guard<std::mutex> lock(_cacheMutex);
+		_stopping = true;
+	}
+	_wakeUp.notify_one();
+	_generator.join();
+}
+
+void ChunkedWorld::Reset(const unsigned int seed)
+{
+	{
+		std::lock_guard<std::mutex> lock(_cacheMutex);
+		_seed = seed;
+		_pending.clear();
+		for (Chunk& chunk : _cache)
+			chunk.LastUse = 0;
+		_useCounter = 0;
+	}
+
+	_center = { 0, 0 };
+	_AssembleWindow();
+}
+
+bool ChunkedWorld::Recenter(const int worldX, const int worldY)
+{
+	Vector2n center { FloorDiv(worldX, CHUNK_SIZE), FloorDiv(worldY, CHUNK_SIZE) };
+	if (center == _center)
+		return false;
+
+	_center = center;
+	_AssembleWindow();
+	return true;
+}
+
+OccupancyView ChunkedWorld::GetWindow() const { return _window.GetView(); }
+const OccupancyGrid& ChunkedWorld::GetWindowGrid() const { return _window; }
+
+Vector2n ChunkedWorld::GetWindowOrigin() const
+{
+	return { (_center.X - WINDOW_CHUNKS / 2) * CHUNK_SIZE, (_center.Y - WINDOW_CHUNKS / 2) * CHUNK_SIZE };
+}
+
+Vector2n ChunkedWorld::GetStartPos() const { return { 1, 1 }; }
+
+int ChunkedWorld::GetCachedChunkCount() const
+{
+	std::lock_guard<std::mutex> lock(_cacheMutex);
+	return (int)std::count_if(std::begin(_cache), std::end(_cache), [](const Chunk& chunk) { return chunk.LastUse != 0; });
+}
+
+size_t ChunkedWorld::GetMemoryBytes() const
+{
+	return sizeof(_cache) + _window.GetMemoryBytes() + _generatorMaze.GetMap().GetMemoryBytes() + _fallbackMaze.GetMap().GetMemoryBytes();
+}
+
+void ChunkedWorld::_AssembleWindow()
+{
+	const Vector2n first { _center.X - WINDOW_CHUNKS / 2, _center.Y - WINDOW_CHUNKS / 2 };
+
+	for (int windowY = 0; windowY < WINDOW_CHUNKS; windowY++)
+		for (int windowX = 0; windowX < WINDOW_CHUNKS; windowX++)
+		{
+			const Vector2n coord { first.X + windowX, first.Y + windowY };
+
+			std::unique_lock<std::mutex> lock(_cacheMutex);
+			Chunk* chunk = _FindChunk(coord);
+			if (!chunk)
+			{
+				// the generator has not got here yet, one chunk is far cheaper to make than to wait for
+				lock.unlock();
+				Chunk generated;
+				_GenerateChunk(_fallbackMaze, _seed, coord, generated);
+				lock.lock();
+
+				_StoreChunk(generated);
+				chunk = _FindChunk(coord);
+			}
+
+			chunk->LastUse = ++_useCounter;
+			for (int tileY = 0; tileY < CHUNK_TILES; tileY++)
+				for (int tileX = 0; tileX < CHUNK_TILES; tileX++)
+					_window.SetTile(windowX * CHUNK_TILES + tileX, windowY * CHUNK_TILES + tileY, chunk->Tiles[tileY * CHUNK_TILES + tileX]);
+		}
+
+	_RequestPrefetch();
+}
+
+void ChunkedWorld::_RequestPrefetch()
+{
+	{
+		std::lock_guard<std::mutex> lock(_cacheMutex);
+
+		// nearest rings first, the ones the player reaches next should not wait behind far corners
+		_pending.clear();
+		for (int ring = 1; ring <= PREFETCH_RADIUS; ring++)
+			for (int y = -ring; y <= ring; y++)
+				for (int x = -ring; x <= ring; x++)
+				{
+					Vector2n coord { _center.X + x, _center.Y + y };
+					if (std::max(abs(x), abs(y)) == ring && !_FindChunk(coord))
+						_pending.push_back(coord);
+				}
+	}
+	_wakeUp.notify_one();
+}
+
+void ChunkedWorld::_GeneratorLoop()
+{
+	while (true)
+	{
+		Vector2n coord;
+		unsigned int seed;
+		{
+			std::unique_lock<std::mutex> lock(_cacheMutex);
+			_wakeUp.wait(lock, [this] { return _stopping || !_pending.empty(); });
+			if (_stopping)
+				return;
+
+			coord = _pending.front();
+			_pending.pop_front();
+			seed = _seed;
+			if (_FindChunk(coord))
+				continue;
+		}
+
+		Chunk chunk;
+		_GenerateChunk(_generatorMaze, seed, coord, chunk);
+
+		// a Reset in the meantime makes this chunk belong to another world
+		std::lock_guard<std::mutex> lock(_cacheMutex);
+		if (chunk.Seed == _seed && !_FindChunk(coord))
+			_StoreChunk(chunk);
+	}
+}
+
+void ChunkedWorld::_GenerateChunk(Maze& scratch, const unsigned int seed, const Vector2n& coord, Chunk& chunk)
+{
+	const int mazeSize = CHUNK_SIZE / 2;
+	scratch.Carve(mazeSize, mazeSize, HashChunk(seed, coord, CHUNK_MAZE_SALT));
+
+	// the maze's right and bottom border walls belong to the next chunks,
+	// what is left is exactly the first CHUNK_TILES x CHUNK_TILES tiles of its map
+	const OccupancyGrid& map = scratch.GetMap();
+	for (int tileY = 0; tileY < CHUNK_TILES; tileY++)
+		for (int tileX = 0; tileX < CHUNK_TILES; tileX++)
+			chunk.Tiles[tileY * CHUNK_TILES + tileX] = map.GetTile(tileX, tileY);
+
+	// openings into the left and top neighbours, always on a maze cell's row or column
+	unsigned int doors = HashChunk(seed, coord, CHUNK_DOOR_SALT);
+	for (int i = 0; i < CHUNK_DOORS_PER_BORDER; i++)
+	{
+		int leftDoorY = (int)((doors >> (i * 8)) % mazeSize) * 2 + 1;
+		int topDoorX = (int)((doors >> (16 + i * 8)) % mazeSize) * 2 + 1;
+
+		chunk.Tiles[(leftDoorY >> 3) * CHUNK_TILES] &= ~((uint64_t)1 << ((leftDoorY & 7) << 3));
+		chunk.Tiles[topDoorX >> 3] &= ~((uint64_t)1 << (topDoorX & 7));
+	}
+
+	chunk.Coord = coord;
+	chunk.Seed = seed;
+	chunk.LastUse = 0;
+}
+
+ChunkedWorld::Chunk* ChunkedWorld::_FindChunk(const Vector2n& coord)
+{
+	for (Chunk& chunk : _cache)
+		if (chunk.LastUse != 0 && chunk.Coord == coord && chunk.Seed == _seed)
+			return &chunk;
+	return nullptr;
+}
+
+void ChunkedWorld::_StoreChunk(const Chunk& chunk)
+{
+	// an empty slot has LastUse 0, so it is always the least recently used one
+	Chunk* slot = std::min_element(std::begin(_cache), std::end(_cache),
+		[](const Chunk& lhs, const Chunk& rhs) { return lhs.LastUse < rhs.LastUse; });
+
+	*slot = chunk;
+	slot->LastUse = ++_useCounter;
+}
\ No newline at end of file
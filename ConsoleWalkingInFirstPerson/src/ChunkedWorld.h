@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Vector2.h"
+#include "Maze.h"
+#include "OccupancyGrid.h"
+
+// endless maze made of fixed size chunks, each generated from (seed, chunk coordinate) alone
+// a chunk is a perfect maze that owns its left and top border walls and opens both at hashed spots,
+// so it always connects to all four neighbours and nothing depends on the order chunks were made in
+// the chunks around the player are copied into one window grid which the renderer and collisions read like
+// any other map, chunks further out are generated ahead on a background thread into a bounded LRU cache
+class ChunkedWorld
+{
+public:
+	// map cells per chunk side, a whole number of 8x8 occupancy tiles
+	static const int CHUNK_SIZE = 32;
+	// chunks per window side, the player's chunk is the middle one so rays end inside the window
+	static const int WINDOW_CHUNKS = 3;
+
+	ChunkedWorld();
+	~ChunkedWorld();
+
+	ChunkedWorld(const ChunkedWorld&) = delete;
+	ChunkedWorld& operator=(const ChunkedWorld&) = delete;
+
+	// forgets every chunk and centers the window on chunk 0, 0
+	void Reset(const unsigned int seed);
+	// centers the window on the chunk holding world cell x, y, returns false when it already was
+	bool Recenter(const int worldX, const int worldY);
+
+	OccupancyView GetWindow() const;
+	const OccupancyGrid& GetWindowGrid() const;
+	// world cell of the window's top left corner
+	Vector2n GetWindowOrigin() const;
+	// world cell the player starts on, inside chunk 0, 0
+	Vector2n GetStartPos() const;
+
+	int GetCachedChunkCount() const;
+	size_t GetMemoryBytes() const;
+
+private:
+	static const int CHUNK_TILES = CHUNK_SIZE / 8;
+	// chunks this far from the window's center are generated ahead
+	static const int PREFETCH_RADIUS = 2;
+	static const int CACHE_CAPACITY = 64;
+
+	struct Chunk
+	{
+		Vector2n Coord;
+		unsigned int Seed;
+		// 0 - empty slot
+		unsigned long long LastUse;
+		uint64_t Tiles[CHUNK_TILES * CHUNK_TILES];
+	};
+
+	unsigned int _seed;
+	Vector2n _center;
+	OccupancyGrid _window;
+
+	// fixed slots so the cache never allocates, few enough that a linear scan is the lookup
+	Chunk _cache[CACHE_CAPACITY];
+	unsigned long long _useCounter;
+	mutable std::mutex _cacheMutex;
+
+	std::deque<Vector2n> _pending;
+	std::condition_variable _wakeUp;
+	bool _stopping;
+	std::thread _generator;
+
+	// scratch of the generator thread and of the game thread, for chunks the generator has not reached yet
+	Maze _generatorMaze;
+	Maze _fallbackMaze;
+
+	void _AssembleWindow();
+	void _GeneratorLoop();
+	static void _GenerateChunk(Maze& scratch, const unsigned int seed, const Vector2n& coord, Chunk& chunk);
+	// _cacheMutex has to be held
+	Chunk* _FindChunk(const Vector2n& coord);
+	void _StoreChunk(const Chunk& chunk);
+	void _RequestPrefetch();
+};
\ No newline at end of file
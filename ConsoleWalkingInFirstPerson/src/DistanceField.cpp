@@ -0,0 +1,95 @@
+#include "DistanceField.h"
+
+#include <algorithm>
+
+const int DistanceField::MAX_CLEARANCE;
+
+DistanceField::DistanceField()
+	:	WIDTH(0), HEIGHT(0), _clearance(), _window()
+{}
+
+DistanceField::~DistanceField() {}
+
+// two pass chessboard distance transform of the window [left, left + width) x [top, top + height),
+// walls outside the window are not seen, cells outside the map are walls
+void DistanceField::_Transform(const OccupancyGrid& map, int left, int top, int width, int height, uint8_t* clearance)
+{
+	const int mapWidth = map.GetWidth(), mapHeight = map.GetHeight();
+
+	// neighbour value for the passes, 0 past the map edge, out of reach past the window edge
+	auto neighbour = [&](int x, int y) -> int
+	{
+		if (x + left < 0 || x + left >= mapWidth || y + top < 0 || y + top >= mapHeight)
+			return 0;
+		if (x < 0 || x >= width || y < 0 || y >= height)
+			return MAX_CLEARANCE;
+		return clearance[y * width + x];
+	};
+
+	// forward pass pulls distances from above and the left
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			int distance = 0;
+			if (!map.IsWall(x + left, y + top))
+			{
+				int nearest = std::min({ neighbour(x - 1, y - 1), neighbour(x, y - 1), neighbour(x + 1, y - 1), neighbour(x - 1, y) });
+				distance = std::min(nearest + 1, MAX_CLEARANCE);
+			}
+			clearance[y * width + x] = (uint8_t)distance;
+		}
+	}
+
+	// backward pass pulls them from below and the right
+	for (int y = height - 1; y >= 0; y--)
+	{
+		for (int x = width - 1; x >= 0; x--)
+		{
+			int distance = clearance[y * width + x];
+			if (distance == 0)
+				continue;
+
+			int nearest = std::min({ neighbour(x + 1, y), neighbour(x - 1, y + 1), neighbour(x, y + 1), neighbour(x + 1, y + 1) });
+			clearance[y * width + x] = (uint8_t)std::min(distance, nearest + 1);
+		}
+	}
+}
+
+void DistanceField::Build(const OccupancyGrid& map)
+{
+	WIDTH = map.GetWidth(); HEIGHT = map.GetHeight();
+	_clearance.resize((size_t)WIDTH * HEIGHT);
+	_Transform(map, 0, 0, WIDTH, HEIGHT, _clearance.data());
+}
+
+void DistanceField::UpdateCell(const OccupancyGrid& map, int x, int y)
+{
+	// a cell further than MAX_CLEARANCE from the change keeps its clamped value, and every wall that
+	// decides a changed cell is within MAX_CLEARANCE of it, so the window spans twice that
+	const int reach = MAX_CLEARANCE, margin = MAX_CLEARANCE * 2;
+
+	int left = std::max(x - margin, 0), top = std::max(y - margin, 0);
+	int right = std::min(x + margin, WIDTH - 1), bottom = std::min(y + margin, HEIGHT - 1);
+	int width = right - left + 1, height = bottom - top + 1;
+
+	_window.resize((size_t)width * height);
+	_Transform(map, left, top, width, height, _window.data());
+
+	for (int cellY = std::max(y - reach, 0); cellY <= std::min(y + reach, HEIGHT - 1); cellY++)
+		for (int cellX = std::max(x - reach, 0); cellX <= std::min(x + reach, WIDTH - 1); cellX++)
+			_clearance[(size_t)cellY * WIDTH + cellX] = _window[(cellY - top) * width + (cellX - left)];
+}
+
+void DistanceField::Assign(const DistanceFieldView& view)
+{
+	WIDTH = view.Width; HEIGHT = view.Height;
+	_clearance.assign(view.Clearance, view.Clearance + (size_t)WIDTH * HEIGHT);
+}
+
+DistanceFieldView DistanceField::GetView() const
+{
+	return { _clearance.data(), WIDTH, HEIGHT };
+}
+
+size_t DistanceField::GetMemoryBytes() const { return _clearance.size(); }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "OccupancyGrid.h"
+
+// chebyshev distance from every cell to the nearest wall, cells outside the map count as walls
+// a cell with clearance c has only empty cells within c - 1 cells of it, so a ray may jump across that square
+
+// non-owning, cheap to copy, valid while the field it came from is alive and not rebuilt at another size
+struct DistanceFieldView
+{
+	// nullptr - no field, rays walk every cell
+	const uint8_t* Clearance;
+	int Width;
+	int Height;
+
+	// x, y have to be inside the map, walls are 0
+	int GetClearance(int x, int y) const { return Clearance[y * Width + x]; }
+};
+
+class DistanceField
+{
+public:
+	DistanceField();
+	~DistanceField();
+
+	void Build(const OccupancyGrid& map);
+	// call after map.SetWall(x, y, ...), recomputes only the cells that one change can reach
+	void UpdateCell(const OccupancyGrid& map, int x, int y);
+	// copy of a field built earlier, e.g. one saved to a maze file
+	void Assign(const DistanceFieldView& view);
+
+	DistanceFieldView GetView() const;
+	size_t GetMemoryBytes() const;
+
+private:
+	// clearance is clamped, which also bounds how far a single cell change reaches
+	static const int MAX_CLEARANCE = 32;
+
+	int WIDTH, HEIGHT;
+	std::vector<uint8_t> _clearance;
+
+	// scratch window of UpdateCell, kept so editing cells does not allocate
+	std::vector<uint8_t> _window;
+
+	static void _Transform(const OccupancyGrid& map, int left, int top, int width, int height, uint8_t* clearance);
+};
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "FlowField.h"
+
+#include "MathUtils.h"
+
+const uint32_t FlowField::DISTANCE_MASK;
+const int FlowField::OPEN_SHIFT;
+const int FlowField::STEP_SHIFT;
+
+static int OppositeStep(const int step) { return (step + 2) & 3; }
+
+
+FlowField::FlowField()
+	:	MAZE_WIDTH(0), MAZE_HEIGHT(0), _exitPos(), _maxDistance(0), _cells(), _queue()
+{}
+
+FlowField::~FlowField() {}
+
+void FlowField::Build(const OccupancyGrid& map, const Vector2n* exits, const int exitCount)
+{
+	MAZE_WIDTH = (map.GetWidth() - 1) / 2; MAZE_HEIGHT = (map.GetHeight() - 1) / 2;
+	_exitPos = exitCount > 0 ? exits[0] : Vector2n(-1, -1);
+
+	const size_t cellCount = (size_t)MAZE_WIDTH * MAZE_HEIGHT;
+	// a path could outgrow the distance bits, such a maze gets no field
+	if (cellCount > DISTANCE_MASK)
+	{
+		std::vector<uint32_t>().swap(_cells);
+		std::vector<uint32_t>().swap(_queue);
+		_maxDistance = 0;
+		return;
+	}
+
+	_cells.resize(cellCount);
+	_queue.resize(cellCount);
+	size_t head = 0, tail = 0;
+
+	// one sequential pass over the map puts each cell's open sides into its own word,
+	// so the search below only ever touches the cells it visits
+	const OccupancyView view = map.GetView();
+	for (int y = 0; y < MAZE_HEIGHT; y++)
+	{
+		const int mapY = y * 2 + 1;
+		uint32_t* row = &_cells[(size_t)y * MAZE_WIDTH];
+
+		// walls are random, so the bits are put together without branching on them
+		for (int x = 0; x < MAZE_WIDTH; x++)
+		{
+			const int mapX = x * 2 + 1;
+			const uint32_t open =
+				  (uint32_t)!view.IsWall(mapX + 1, mapY)
+				| (uint32_t)!view.IsWall(mapX, mapY + 1) << 1
+				| (uint32_t)!view.IsWall(mapX - 1, mapY) << 2
+				| (uint32_t)!view.IsWall(mapX, mapY - 1) << 3;
+			row[x] = DISTANCE_MASK | (open << OPEN_SHIFT);
+		}
+
+		// an exit is a hole in the border, it does not lead to another maze cell
+		row[0] &= ~(1u << (OPEN_SHIFT + (int)FlowStep::NegativeX));
+		row[MAZE_WIDTH - 1] &= ~(1u << (OPEN_SHIFT + (int)FlowStep::PositiveX));
+		if (y == 0)
+			for (int x = 0; x < MAZE_WIDTH; x++)
+				row[x] &= ~(1u << (OPEN_SHIFT + (int)FlowStep::NegativeY));
+		if (y == MAZE_HEIGHT - 1)
+			for (int x = 0; x < MAZE_WIDTH; x++)
+				row[x] &= ~(1u << (OPEN_SHIFT + (int)FlowStep::PositiveY));
+	}
+
+	// a maze cell next to an exit is one map cell away from it, and steps out through it
+	for (int i = 0; i < exitCount; i++)
+		for (int step = 0; step < 4; step++)
+		{
+			const int mapX = exits[i].X - STEP_X[step], mapY = exits[i].Y - STEP_Y[step];
+			if ((mapX & 1) && (mapY & 1) && 0 < mapX && mapX < map.GetWidth() && 0 < mapY && mapY < map.GetHeight())
+			{
+				const uint32_t cell = (uint32_t)((mapY >> 1) * MAZE_WIDTH + (mapX >> 1));
+				if ((_cells[cell] & DISTANCE_MASK) == DISTANCE_MASK)
+				{
+					_cells[cell] = (_cells[cell] & (0xFu << OPEN_SHIFT)) | ((uint32_t)step << STEP_SHIFT);
+					_queue[tail++] = cell;
+				}
+			}
+		}
+
+	// neighbours as index offsets in FlowStep order, open sides never lead off the maze
+	const int NEIGHBOUR_OFFSET[4] = { 1, MAZE_WIDTH, -1, -MAZE_WIDTH };
+
+	uint32_t distance = 0;
+	while (head < tail)
+	{
+		const uint32_t cell = _queue[head++];
+		const uint32_t word = _cells[cell];
+		distance = word & DISTANCE_MASK;
+
+		for (uint32_t open = (word >> OPEN_SHIFT) & 0xF; open != 0; open &= open - 1)
+		{
+			const int step = open & 1 ? 0 : open & 2 ? 1 : open & 4 ? 2 : 3;
+			const uint32_t next = cell + NEIGHBOUR_OFFSET[step];
+
+			const uint32_t nextWord = _cells[next];
+			if ((nextWord & DISTANCE_MASK) != DISTANCE_MASK)
+				continue;
+
+			_cells[next] = (distance + 1) | (nextWord & (0xFu << OPEN_SHIFT)) | ((uint32_t)OppositeStep(step) << STEP_SHIFT);
+			_queue[tail++] = next;
+		}
+	}
+
+	// cells come out of the queue in order of distance, so the last one is the furthest
+	_maxDistance = tail > 0 ? (int)distance * 2 + 1 : 0;
+}
+
+void FlowField::Assign(const FlowFieldView& view)
+{
+	MAZE_WIDTH = view.MazeWidth; MAZE_HEIGHT = view.MazeHeight;
+	_exitPos = view.ExitPos;
+	_maxDistance = view.MaxDistance;
+	_cells.assign(view.Cells, view.Cells + (size_t)MAZE_WIDTH * MAZE_HEIGHT);
+}
+
+FlowFieldView FlowField::GetView() const
+{
+	return { _cells.empty() ? nullptr : _cells.data(), MAZE_WIDTH, MAZE_HEIGHT, _exitPos, _maxDistance };
+}
+
+size_t FlowField::GetMemoryBytes() const { return (_cells.size() + _queue.size()) * sizeof(uint32_t); }
+
+
+// map distance of a maze cell is two per step plus the one out through the exit
+int FlowFieldView::GetDistance(int mapX, int mapY) const
+{
+	if (mapX == ExitPos.X && mapY == ExitPos.Y)
+		return 0;
+
+	// on a maze cell, or on the passage between two, which is one closer than the further of them
+	const int leftX = (mapX - 1) >> 1, topY = (mapY - 1) >> 1;
+	const int rightX = mapX >> 1, bottomY = mapY >> 1;
+	int best = -1;
+	for (int y = topY; y <= bottomY; y++)
+		for (int x = leftX; x <= rightX; x++)
+		{
+			if (x < 0 || x >= MazeWidth || y < 0 || y >= MazeHeight)
+				continue;
+			const uint32_t distance = Cells[y * MazeWidth + x] & FlowField::DISTANCE_MASK;
+			if (distance != FlowField::DISTANCE_MASK && (best < 0 || (int)distance < best))
+				best = (int)distance;
+		}
+
+	if (best < 0)
+		return -1;
+	return (mapX & 1) && (mapY & 1) ? best * 2 + 1 : best * 2 + 2;
+}
+
+bool FlowFieldView::GetStep(int mapX, int mapY, FlowStep& step) const
+{
+	if ((mapX & 1) && (mapY & 1))
+	{
+		// a player stepping past the exit in one long frame stands off the map
+		if ((mapX >> 1) < 0 || (mapX >> 1) >= MazeWidth || (mapY >> 1) < 0 || (mapY >> 1) >= MazeHeight)
+			return false;
+		const uint32_t cell = Cells[(mapY >> 1) * MazeWidth + (mapX >> 1)];
+		if ((cell & FlowField::DISTANCE_MASK) == FlowField::DISTANCE_MASK)
+			return false;
+		step = (FlowStep)(cell >> FlowField::STEP_SHIFT);
+		return true;
+	}
+
+	// on a passage, towards whichever side is closer, exits only ever touch maze cells
+	int distance = GetDistance(mapX, mapY);
+	for (int i = 0; i < 4; i++)
+	{
+		const int x = mapX + STEP_X[i], y = mapY + STEP_Y[i];
+		if ((x & 1) && (y & 1) && 0 <= (x >> 1) && (x >> 1) < MazeWidth && 0 <= (y >> 1) && (y >> 1) < MazeHeight
+			&& GetDistance(x, y) == distance - 1)
+		{
+			step = (FlowStep)i;
+			return true;
+		}
+	}
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Vector2.h"
+#include "OccupancyGrid.h"
+
+// path distance and first step from every maze cell to the nearest exit, from one breadth first search
+// maze cells sit on odd map coordinates with walls or passages between them, one packed word per maze cell
+// keeps a 4096x4096 maze at 64 MB where a word per map cell would take four times that, the search queue takes as much again
+
+// step directions, the way to go from a cell towards the exit
+enum class FlowStep { PositiveX = 0, PositiveY = 1, NegativeX = 2, NegativeY = 3 };
+
+// non-owning, cheap to copy, valid while the field it came from is alive and not rebuilt at another size
+struct FlowFieldView
+{
+	// nullptr - no field
+	const uint32_t* Cells;
+	int MazeWidth;
+	int MazeHeight;
+	Vector2n ExitPos;
+	// longest path in map cells, for normalizing
+	int MaxDistance;
+
+	// map cells to the exit, -1 where the exit cannot be reached, x, y has to be an empty map cell
+	int GetDistance(int mapX, int mapY) const;
+	// first step towards the exit, false where there is none or off the map, x, y has to be an empty map cell
+	bool GetStep(int mapX, int mapY, FlowStep& step) const;
+};
+
+class FlowField
+{
+public:
+	FlowField();
+	~FlowField();
+
+	// every exit is a source, an exit is a map cell next to a maze cell, usually an opening in the border
+	void Build(const OccupancyGrid& map, const Vector2n* exits, const int exitCount);
+	// copy of a field built earlier, e.g. one saved to a maze file
+	void Assign(const FlowFieldView& view);
+
+	FlowFieldView GetView() const;
+	size_t GetMemoryBytes() const;
+
+private:
+	// a cell is its distance in steps between maze cells, one bit per open side in FlowStep order
+	// and its FlowStep on top, 26 bits of distance cover any path of a 4096x4096 maze, bigger mazes are left without a field
+	static const uint32_t DISTANCE_MASK = 0x03FFFFFFu;
+	static const int OPEN_SHIFT = 26;
+	static const int STEP_SHIFT = 30;
+
+	int MAZE_WIDTH, MAZE_HEIGHT;
+	Vector2n _exitPos;
+	int _maxDistance;
+	std::vector<uint32_t> _cells;
+
+	// breadth first queue, kept so rebuilding a field of the same size does not allocate
+	std::vector<uint32_t> _queue;
+
+	friend struct FlowFieldView;
+};
\ No newline at end of file
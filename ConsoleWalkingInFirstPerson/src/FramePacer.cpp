@@ -0,0 +1,48 @@
+#include "FramePacer.h"
+
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+FramePacer::FramePacer(const int targetFps)
+	:	FRAME_TIME(), _nextFrame(), _started(false)
+{
+	if (targetFps > 0)
+		FRAME_TIME = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+
+#ifdef _WIN32
+	// default timer resolution is ~15.6 ms, a sleep would overshoot a 60 fps frame by a whole tick
+	if (targetFps > 0)
+		timeBeginPeriod(1);
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	if (FRAME_TIME.count() > 0)
+		timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::Wait()
+{
+	if (FRAME_TIME.count() <= 0)
+		return;
+
+	auto now = std::chrono::steady_clock::now();
+
+	// a frame that ran more than a whole budget over starts a new schedule instead of rushing to catch up
+	if (!_started || now - _nextFrame > FRAME_TIME)
+	{
+		_nextFrame = now;
+		_started = true;
+	}
+	else if (now < _nextFrame)
+		std::this_thread::sleep_until(_nextFrame);
+
+	_nextFrame += FRAME_TIME;
+}
\ No newline at end of file
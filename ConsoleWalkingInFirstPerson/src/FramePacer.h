@@ -0,0 +1,20 @@
+#pragma once
+
+#include <chrono>
+
+// caps the frame rate by sleeping out what is left of every frame's budget
+class FramePacer
+{
+public:
+	// 0 - no cap, Wait returns at once
+	explicit FramePacer(const int targetFps);
+	~FramePacer();
+
+	// call once per frame after the frame went out
+	void Wait();
+
+private:
+	std::chrono::steady_clock::duration FRAME_TIME;
+	std::chrono::steady_clock::time_point _nextFrame;
+	bool _started;
+};
\ No newline at end of file
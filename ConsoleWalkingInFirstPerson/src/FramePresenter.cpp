@@ -0,0 +1,89 @@
+#include "FramePresenter.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+
+FramePresenter::FramePresenter(Terminal& terminal, const int screenSize)
+	:	_terminal(terminal), _frames(), _back(0), _ready(1), _front(2), _last(1),
+		_hasReady(false), _stopping(false), _mutex(), _frameReady(), _latencyMs(0.0f), _droppedFrames(0), _thread()
+{
+	for (Frame& frame : _frames)
+		frame.Screen.assign(screenSize, L' ');
+
+	_thread = std::thread(&FramePresenter::_PresentLoop, this);
+}
+
+FramePresenter::~FramePresenter()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_frameReady.notify_one();
+	_thread.join();
+}
+
+wchar_t* FramePresenter::GetBackBuffer()
+{
+	return _frames[_back].Screen.data();
+}
+
+void FramePresenter::Submit(std::chrono::steady_clock::time_point frameStart)
+{
+	_frames[_back].Start = frameStart;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_hasReady)
+			_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+
+		std::swap(_back, _ready);
+		_last = _ready;
+		_hasReady = true;
+	}
+	_frameReady.notify_one();
+}
+
+void FramePresenter::CopyLastFrame()
+{
+	// the presenter only reads the last frame, so copying out of it while it goes out is fine
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::copy(_frames[_last].Screen.begin(), _frames[_last].Screen.end(), _frames[_back].Screen.begin());
+}
+
+float FramePresenter::GetLatencyMs() const
+{
+	return _latencyMs.load(std::memory_order_relaxed);
+}
+
+int FramePresenter::GetDroppedFrameCount() const
+{
+	return _droppedFrames.load(std::memory_order_relaxed);
+}
+
+void FramePresenter::_PresentLoop()
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_frameReady.wait(lock, [this] { return _hasReady || _stopping; });
+
+			// a frame submitted right before shutdown still goes out
+			if (!_hasReady)
+				return;
+
+			std::swap(_front, _ready);
+			_hasReady = false;
+		}
+
+		{
+			PROFILE_STAGE(FrameStage::Present);
+			_terminal.Present(_frames[_front].Screen.data());
+		}
+
+		std::chrono::duration<float, std::milli> latency = std::chrono::steady_clock::now() - _frames[_front].Start;
+		_latencyMs.store(latency.count(), std::memory_order_relaxed);
+	}
+}
\ No newline at end of file
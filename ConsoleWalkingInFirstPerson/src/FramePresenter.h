@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Terminal.h"
+
+// presents finished frames on its own thread so terminal output overlaps drawing the next frame,
+// three screens rotate between the game thread, the newest finished frame and the one on its way out,
+// a finished frame the presenter has not picked up by the next Submit is dropped
+class FramePresenter
+{
+public:
+	FramePresenter(Terminal& terminal, const int screenSize);
+	~FramePresenter();
+
+	FramePresenter(const FramePresenter&) = delete;
+	FramePresenter& operator=(const FramePresenter&) = delete;
+
+	// screen the game thread draws the next frame into, changes with every Submit
+	wchar_t* GetBackBuffer();
+	// hands the back buffer over, frameStart is when the frame's input was read
+	void Submit(std::chrono::steady_clock::time_point frameStart);
+	// back buffer gets the last submitted frame, for screens drawn on top of it
+	void CopyLastFrame();
+
+	// from frameStart to the end of Present, of the last frame that went out
+	float GetLatencyMs() const;
+	int GetDroppedFrameCount() const;
+
+private:
+	struct Frame
+	{
+		std::vector<wchar_t> Screen;
+		std::chrono::steady_clock::time_point Start;
+	};
+
+	Terminal& _terminal;
+	Frame _frames[3];
+
+	// indices into _frames, _back belongs to the game thread and _front to the presenter, they trade
+	// with _ready under the mutex, _last is whichever of _ready and _front was submitted most recently
+	int _back, _ready, _front, _last;
+	bool _hasReady;
+	bool _stopping;
+
+	std::mutex _mutex;
+	std::condition_variable _frameReady;
+	std::atomic<float> _latencyMs;
+	std::atomic<int> _droppedFrames;
+	std::thread _thread;
+
+	void _PresentLoop();
+};
\ No newline at end of file
@@ -0,0 +1,642 @@
+#include "Game.h"
+
+#include <string.h>
+#include <wchar.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "Raycaster.h"
+#include "Transpose.h"
+#include "Profiler.h"
+#include "MathUtils.h"
+
+
+const float MAX_RENDERING_DISTANCE = 16.0f;
+
+// columns are rendered in tiles of this many screen cells, 64 bytes of a row, so threads only meet where two tiles do,
+// rows are not a multiple of 64 bytes and the buffers are not aligned, so those edges can still share a cache line
+const int RENDER_TILE_COLUMNS = 64 / sizeof(wchar_t);
+
+// neighbouring rays further apart in depth than this ratio straddle a wall edge, columns between them are not blended
+const float RECONSTRUCT_MAX_DEPTH_RATIO = 1.25f;
+
+const float PLAYER_WALK_SPEED = 3.0f;
+const float PLAYER_ROTATION_SPEED = 1.6f;
+
+
+Vector2n SCREEN_DIMENSIONS { 120, 40 };
+
+bool _reuseRays = true;
+bool _useDistanceField = false;
+MazeAlgorithm _mazeAlgorithm = MazeAlgorithm::DepthFirst;
+
+
+static bool WorldPosHasWall(const OccupancyView& map, const Vector2f& worldPos)
+{
+	Vector2n mapPosToCheck { (int)worldPos.X, (int)worldPos.Y };
+	if (map.Contains(mapPosToCheck.X, mapPosToCheck.Y))
+		return map.IsWall(mapPosToCheck.X, mapPosToCheck.Y);
+	else
+		return false;
+}
+
+void MoveWalkers(const OccupancyView& map, const InputState* inputs, const int count, const float elapsedTime,
+	float* posX, float* posY, float* angles)
+{
+	const float walkAmount = PLAYER_WALK_SPEED * elapsedTime;
+	const float rotationAmount = PLAYER_ROTATION_SPEED * elapsedTime;
+
+	for (int i = 0; i < count; i++)
+	{
+		const InputState& input = inputs[i];
+		float angle = angles[i];
+
+		Vector2f forwardsMoveAmount = Vector2f(cosf(angle), sinf(angle)) * walkAmount;
+		Vector2f sidewaysMoveAmount = Vector2f(cosf(angle + PI / 2), sinf(angle + PI / 2)) * walkAmount;
+
+		Vector2f newPos { posX[i], posY[i] };
+
+		if (input.MoveForwards)
+			newPos += forwardsMoveAmount;
+		if (input.MoveBackwards)
+			newPos -= forwardsMoveAmount;
+
+		if (input.MoveRight)
+			newPos += sidewaysMoveAmount;
+		if (input.MoveLeft)
+			newPos -= sidewaysMoveAmount;
+
+		if (!WorldPosHasWall(map, newPos))
+		{
+			posX[i] = newPos.X;
+			posY[i] = newPos.Y;
+		}
+
+
+		if (input.RotateLeft)
+			angle -= rotationAmount;
+		if (input.RotateRight)
+			angle += rotationAmount;
+
+		angles[i] = fmod(angle, PI * 2);
+	}
+}
+
+void HandleInput(const GameWorld& world, PlayerState& player, const InputState& input, float elapsedTime)
+{
+	MoveWalkers(world.Map, &input, 1, elapsedTime, &player.Pos.X, &player.Pos.Y, &player.Angle);
+
+	if (input.ToggleMap)
+		player.MapIsVisible = !player.MapIsVisible;
+	if (input.ToggleDebug)
+		player.InDebug = !player.InDebug;
+}
+
+// along the maze's paths when it has a flow field, 0 only on the exit itself
+static float GetNormalizedDistanceToEnd(const Vector2f& playerPos, const FlowFieldView& pathToExit, const Vector2n& endPosition, const Vector2n& mapDimensions)
+{
+	if (pathToExit.Cells && pathToExit.MaxDistance > 0)
+	{
+		int distance = pathToExit.GetDistance((int)playerPos.X, (int)playerPos.Y);
+		return distance >= 0 ? std::min((float)distance / pathToExit.MaxDistance, 1.0f) : 1.0f;
+	}
+
+	const Vector2n mapDimWithoutWalls { mapDimensions.X - 2, mapDimensions.Y - 2 };
+	const float maxDistance = abs(mapDimWithoutWalls.X) + abs(mapDimWithoutWalls.Y);
+
+	const Vector2n difference { abs(endPosition.X - (int)playerPos.X), abs(endPosition.Y - (int)playerPos.Y)};
+	return ((difference.X + difference.Y) / maxDistance);
+}
+
+
+void GetDistancesToEnd(const GameWorld& world, const float* posX, const float* posY, const int count, float* distances)
+{
+	for (int i = 0; i < count; i++)
+		distances[i] = world.HasExit ? GetNormalizedDistanceToEnd({ posX[i], posY[i] }, world.PathToExit, world.ExitPos, world.MapDimensions) : 1.0f;
+}
+
+// rotates every column's camera space direction by the view angle, no trig per column
+static void CastColumnRays(const int firstColumn, const int columnCount, const RenderTables& tables, const Vector2f& viewPos, const Vector2f& viewDir,
+	float* rayDirX, float* rayDirY, float* distances, const OccupancyView& map, const DistanceFieldView& field)
+{
+	for (int x = firstColumn; x < firstColumn + columnCount; x++)
+	{
+		float cameraDirX = tables.GetCameraDirX(x), cameraDirY = tables.GetCameraDirY(x);
+		rayDirX[x] = cameraDirX * viewDir.X - cameraDirY * viewDir.Y;
+		rayDirY[x] = cameraDirX * viewDir.Y + cameraDirY * viewDir.X;
+	}
+
+	if (field.Clearance)
+		CastRays(map, field, viewPos, rayDirX + firstColumn, rayDirY + firstColumn, columnCount, MAX_RENDERING_DISTANCE, distances + firstColumn);
+	else
+		CastRays(map, viewPos, rayDirX + firstColumn, rayDirY + firstColumn, columnCount, MAX_RENDERING_DISTANCE, distances + firstColumn);
+}
+
+// screen column the ray of a sample is cast through, first and last samples sit on the screen edges
+static int GetSampleColumn(const int sample, const int sampleCount, const int columns)
+{
+	return (int)((long long)sample * (columns - 1) / (sampleCount - 1));
+}
+
+static void CastSampleRays(const int firstSample, const int count, const int sampleCount, const RenderTables& tables, const Vector2f& viewPos, const Vector2f& viewDir,
+	float* sampleDirX, float* sampleDirY, float* sampleDistances, const OccupancyView& map, const DistanceFieldView& field)
+{
+	for (int sample = firstSample; sample < firstSample + count; sample++)
+	{
+		int x = GetSampleColumn(sample, sampleCount, SCREEN_DIMENSIONS.X);
+		float cameraDirX = tables.GetCameraDirX(x), cameraDirY = tables.GetCameraDirY(x);
+		sampleDirX[sample] = cameraDirX * viewDir.X - cameraDirY * viewDir.Y;
+		sampleDirY[sample] = cameraDirX * viewDir.Y + cameraDirY * viewDir.X;
+	}
+
+	if (field.Clearance)
+		CastRays(map, field, viewPos, sampleDirX + firstSample, sampleDirY + firstSample, count, MAX_RENDERING_DISTANCE, sampleDistances + firstSample);
+	else
+		CastRays(map, viewPos, sampleDirX + firstSample, sampleDirY + firstSample, count, MAX_RENDERING_DISTANCE, sampleDistances + firstSample);
+}
+
+// fills in the distance of every column from the two samples around it, inverse depth is linear across
+// the screen for a flat wall so blending it is exact on walls, across an edge the nearer sample is copied
+static void ReconstructColumnDistances(const int firstColumn, const int columnCount, const int sampleCount, const RenderTables& tables,
+	const float* sampleDistances, float* rayDistances)
+{
+	const int columns = SCREEN_DIMENSIONS.X;
+
+	// samples are walked alongside the columns instead of being looked up per column
+	int sample = std::min((int)((long long)firstColumn * (sampleCount - 1) / (columns - 1)), sampleCount - 2);
+	int leftX = GetSampleColumn(sample, sampleCount, columns);
+	int rightX = GetSampleColumn(sample + 1, sampleCount, columns);
+
+	for (int x = firstColumn; x < firstColumn + columnCount; x++)
+	{
+		while (x > rightX && sample < sampleCount - 2)
+		{
+			sample++;
+			leftX = rightX;
+			rightX = GetSampleColumn(sample + 1, sampleCount, columns);
+		}
+
+		float t = (float)(x - leftX) / (float)(rightX - leftX);
+		float leftDistance = sampleDistances[sample], rightDistance = sampleDistances[sample + 1];
+		float leftDepth = leftDistance * tables.GetDepthFactor(leftX);
+		float rightDepth = rightDistance * tables.GetDepthFactor(rightX);
+
+		bool bothHit = leftDistance < MAX_RENDERING_DISTANCE && rightDistance < MAX_RENDERING_DISTANCE;
+		if (bothHit && std::max(leftDepth, rightDepth) <= std::min(leftDepth, rightDepth) * RECONSTRUCT_MAX_DEPTH_RATIO)
+		{
+			float inverseDepth = (1.0f - t) / leftDepth + t / rightDepth;
+			rayDistances[x] = 1.0f / (inverseDepth * tables.GetDepthFactor(x));
+		}
+		else
+		{
+			float distance = t < 0.5f ? leftDistance : rightDistance;
+			float depth = t < 0.5f ? leftDepth : rightDepth;
+			rayDistances[x] = distance < MAX_RENDERING_DISTANCE ? depth / tables.GetDepthFactor(x) : MAX_RENDERING_DISTANCE;
+		}
+	}
+}
+
+static void WriteColumn(wchar_t* column, const int x, const float rayDistance, const RenderTables& tables)
+{
+	// perpendicular distance to the camera plane, euclidean one bends walls into a fisheye
+	float distanceToWall = rayDistance < MAX_RENDERING_DISTANCE
+		? rayDistance * tables.GetDepthFactor(x)
+		: MAX_RENDERING_DISTANCE;
+
+	const int rows = SCREEN_DIMENSIONS.Y;
+	const int ceilingSize = tables.GetCeilingSize(distanceToWall);
+	const int ceilingEnd = std::min(ceilingSize + 1, rows);
+	const int wallEnd = std::clamp(rows - ceilingSize + 1, ceilingEnd, rows);
+	const wchar_t* floorColumn = tables.GetFloorColumn();
+
+	// column is contiguous, so ceiling, wall and floor are three span fills from the top
+	wmemset(column, L' ', ceilingEnd);
+	wmemset(column + ceilingEnd, tables.GetWallShade(distanceToWall), wallEnd - ceilingEnd);
+	wmemcpy(column + wallEnd, floorColumn + wallEnd, rows - wallEnd);
+}
+
+static void WriteColumnTile(wchar_t* screen, wchar_t* columns, const int tile, const RenderTables& tables, const Vector2f& viewPos, const Vector2f& viewDir,
+	const int firstCastColumn, const int castColumnCount, const bool columnsDrawn, float* rayDirX, float* rayDirY, float* rayDistances, const OccupancyView& map, const DistanceFieldView& field)
+{
+	int firstColumn = tile * RENDER_TILE_COLUMNS;
+	int columnCount = std::min<int>(RENDER_TILE_COLUMNS, SCREEN_DIMENSIONS.X - firstColumn);
+
+	// only columns without a reusable distance get a ray
+	int castBegin = std::max(firstColumn, firstCastColumn);
+	int castEnd = std::min(firstColumn + columnCount, firstCastColumn + castColumnCount);
+	if (castBegin < castEnd)
+		CastColumnRays(castBegin, castEnd - castBegin, tables, viewPos, viewDir, rayDirX, rayDirY, rayDistances, map, field);
+
+	// depth correction depends on the column, so a shifted distance has to be drawn again
+	if (!columnsDrawn)
+		for (int x = firstColumn; x < firstColumn + columnCount; x++)
+			WriteColumn(columns + x * SCREEN_DIMENSIONS.Y, x, rayDistances[x], tables);
+
+	// tiles own separate columns of every screen row, so threads blit their own without locking
+	TransposeColumns(columns, SCREEN_DIMENSIONS.Y, screen, SCREEN_DIMENSIONS.X, firstColumn, columnCount);
+}
+
+struct RayCastRange
+{
+	float ViewAngle;
+	int FirstColumn;
+	int ColumnCount;
+	// the back buffer already holds this exact view
+	bool ColumnsDrawn;
+};
+
+// standing still reuses every distance and drawn column, turning shifts the distances by whole columns
+// and casts only the exposed edge, anything else (moving, new map, new tables, new ray count) casts every ray,
+// rays is how many are cast per frame and the range is in rays, shifting only works with one ray per column
+// a shifted view is up to half a column off the real angle, so the first frame after turning stops casts every ray
+static RayCastRange ReuseCachedRays(RenderBuffers& buffers, const GameWorld& world, const PlayerState& player, bool tablesRebuilt, const int rays)
+{
+	const int columns = SCREEN_DIMENSIONS.X;
+
+	bool turning = player.Angle != buffers.LastPlayerAngle;
+	buffers.LastPlayerAngle = player.Angle;
+
+	if (_reuseRays && buffers.RaysCached && !tablesRebuilt && buffers.CachedRenderColumns == rays
+		&& buffers.CachedMapRevision == world.MapRevision && buffers.CachedPos == player.Pos)
+	{
+		float columnAngle = buffers.Tables.GetColumnAngleStep();
+
+		// HandleInput wraps the angle, crossing the wrap is not a full turn
+		float angleDelta = player.Angle - buffers.CachedAngle;
+		if (angleDelta > PI)
+			angleDelta -= PI * 2;
+		else if (angleDelta < -PI)
+			angleDelta += PI * 2;
+
+		int shift = (int)roundf(angleDelta / columnAngle);
+
+		if (rays == columns && abs(shift) < columns && (turning || angleDelta == 0.0f))
+		{
+			float* distances = buffers.RayDistances.data();
+			RayCastRange range { buffers.CachedAngle + shift * columnAngle, 0, 0, shift == 0 };
+
+			// turning right moves the image left, new columns come in on the right
+			if (shift > 0)
+			{
+				memmove(distances, distances + shift, (columns - shift) * sizeof(float));
+				range.FirstColumn = columns - shift;
+				range.ColumnCount = shift;
+			}
+			else if (shift < 0)
+			{
+				memmove(distances - shift, distances, (columns + shift) * sizeof(float));
+				range.ColumnCount = -shift;
+			}
+
+			buffers.CachedAngle = range.ViewAngle;
+			return range;
+		}
+
+		if (angleDelta == 0.0f)
+			return { player.Angle, 0, 0, true };
+	}
+
+	buffers.RaysCached = true;
+	buffers.CachedPos = player.Pos;
+	buffers.CachedAngle = player.Angle;
+	buffers.CachedMapRevision = world.MapRevision;
+	buffers.CachedRenderColumns = rays;
+	return { player.Angle, 0, rays, false };
+}
+
+static void WriteProgressToEnd(wchar_t* screen, int screenYOffset, const float distanceToEnd)
+{
+	const wchar_t* message;
+	if (distanceToEnd < 0.05)
+		message = L"!!!!!!!!\0";
+	else if (0.05f  <= distanceToEnd && distanceToEnd < 0.125f)
+		message = L"########\0";
+	else if (0.125f <= distanceToEnd && distanceToEnd < 0.25f)
+		message = L"#######-\0";
+	else if (0.25f  <= distanceToEnd && distanceToEnd < 0.375f)
+		message = L"######--\0";
+	else if (0.375f <= distanceToEnd && distanceToEnd < 0.5f)
+		message = L"#####---\0";
+	else if (0.5f   <= distanceToEnd && distanceToEnd < 0.625f)
+		message = L"####----\0";
+	else if (0.625f <= distanceToEnd && distanceToEnd < 0.75f)
+		message = L"###-----\0";
+	else if (0.75f  <= distanceToEnd && distanceToEnd < 0.875f)
+		message = L"##------\0";
+	else if (0.875f <= distanceToEnd && distanceToEnd < 0.95f)
+		message = L"#-------\0";
+	else
+		message = L"--------\0";
+
+	for (size_t i = 0; i < wcslen(message); i++)
+		screen[screenYOffset * SCREEN_DIMENSIONS.X + i] = message[i];
+}
+
+// which way the path to the exit goes from here, relative to where the player looks
+static void WriteHint(wchar_t* screen, int screenY, int screenX, const FlowFieldView& pathToExit, const PlayerState& player)
+{
+	FlowStep step;
+	if (!pathToExit.GetStep((int)player.Pos.X, (int)player.Pos.Y, step))
+		return;
+
+	const float STEP_ANGLES[4] = { 0.0f, PI / 2, PI, -PI / 2 };
+	float turn = fmodf(STEP_ANGLES[(int)step] - player.Angle, PI * 2);
+	if (turn > PI)
+		turn -= PI * 2;
+	else if (turn < -PI)
+		turn += PI * 2;
+
+	// positive angles turn right, screen columns grow with the angle
+	wchar_t arrow;
+	if (fabsf(turn) <= PI / 4)				arrow = L'^';
+	else if (fabsf(turn) >= PI * 3 / 4)		arrow = L'v';
+	else if (turn > 0)						arrow = L'>';
+	else									arrow = L'<';
+
+	screen[screenY * SCREEN_DIMENSIONS.X + screenX] = arrow;
+}
+
+void WriteGameOver(wchar_t* screen)
+{
+	auto message = L"You won!";
+	for (size_t i = 0; i < wcslen(message); i++)
+		screen[i + SCREEN_DIMENSIONS.X * 0] = message[i];
+
+	message = L"If you want to try again press enter";
+	for (size_t i = 0; i < wcslen(message); i++)
+		screen[i + SCREEN_DIMENSIONS.X * 1] = message[i];
+
+	message = L"If you want to exit press escape";
+	for (size_t i = 0; i < wcslen(message); i++)
+		screen[i + SCREEN_DIMENSIONS.X * 2] = message[i];
+}
+
+static void WriteDebugMessage(wchar_t* screen, int screenYOffset, const Vector2n& mapOrigin, const PlayerState& player, float elapsedTime, float latencyMs, float distanceToEnd)
+{
+	wchar_t message[64];
+	swprintf(message, 64, L"X=%3.2f, Y=%3.2f, A=%3.2f, DtE=%1.2f, FPS=%5.0f, LAT=%5.1fms\0",
+		player.Pos.X + mapOrigin.X, player.Pos.Y + mapOrigin.Y, player.Angle, distanceToEnd, 1.0f / elapsedTime, latencyMs);
+
+	for (size_t i = 0; i < wcslen(message); i++)
+		screen[screenYOffset * SCREEN_DIMENSIONS.X + i] = message[i];
+}
+
+#if PROFILER_ENABLED
+// one line per frame stage, ending right above screenYEnd
+static void WriteProfilerStats(wchar_t* screen, int screenYEnd)
+{
+	for (int stage = 0; stage < FRAME_STAGE_COUNT; stage++)
+	{
+		StageStats stats = GetStageStats((FrameStage)stage);
+
+		wchar_t message[64];
+		swprintf(message, 64, L"%-8hs min=%6.3f avg=%6.3f p99=%6.3f ms",
+			GetStageName((FrameStage)stage), stats.MinMs, stats.AvgMs, stats.P99Ms);
+
+		int screenY = screenYEnd - FRAME_STAGE_COUNT + stage;
+		for (size_t i = 0; i < wcslen(message); i++)
+			screen[screenY * SCREEN_DIMENSIONS.X + i] = message[i];
+	}
+}
+#endif
+
+void WriteStartMenu(wchar_t* screen)
+{
+	auto message =
+		LR"(.__                            .___   __           .__                                                                  )"
+		LR"(|__|  __ __  ______  ____    __| _/ _/  |_  ____   |  |    ____ ___  __  ____     _____  _____   ________  ____    _____)"
+		LR"(|  | |  |  \/  ___/_/ __ \  / __ |  \   __\/  _ \  |  |   /  _ \\  \/ / / __ \   /     \ \__  \  \___   /_/ __ \  /  ___)"
+		LR"(|  | |  |  /\___ \ \  ___/ / /_/ |   |  | (  <_> ) |  |__(  <_> )\   / |  ___/  |  Y Y  \ / __ \_ /    / \  ___/  \___ \)"
+		LR"(|__| |____//____  > \___  >\____ |   |__|  \____/  |____/ \____/  \_/   \___  > |__|_|  /(____  //_____ \ \___  >/____  )"
+		LR"(                \/      \/      \/                                          \/        \/      \/       \/     \/      \/)"
+		LR"(                                                                                                                        )"
+		LR"(      ____ _  _ ____     __  ____ ____ ____ ____    ____ __ _ ____ ____ ____ __ __ _  ___    ____ _  _ __ ____          )"
+		LR"(     (  _ / )( (_  _)   / _\(  __(_  _(  __(  _ \  (  __(  ( (_  _(  __(  _ (  (  ( \/ __)  (_  _/ )( (  / ___)         )"
+		LR"(      ) _ ) \/ ( )(    /    \) _)  )(  ) _) )   /   ) _)/    / )(  ) _) )   /)(/    ( (_ \    )( ) __ ()(\___ \         )"
+		LR"(     (____\____/(__)   \_/\_(__)  (__)(____(__\_)  (____\_)__)(__)(____(__\_(__\_)__)\___/   (__)\_)(_(__(____/         )"
+		LR"(      __    __  ____ ____     __  __ _ ____      __ __  _    __ _  __ ____    ____  __     ____ _  _ ____ ____          )"
+		LR"(     (  )  / _\/ ___(_  _)   /  \(  ( (  __)_   (  (( \/ )  (  ( \/  (_  _)  / ___)/  \   / ___/ )( (  _ (  __)         )"
+		LR"(     / (_//    \___ \ )(    (  O /    /) _)( )   )( / \/ \  /    (  O ))(    \___ (  O )  \___ ) \/ ()   /) _)          )"
+		LR"(     \____\_/\_(____/(__)    \__/\_)__(____(/   (__)\_)(_/  \_)__)\__/(__)   (____/\__/   (____\____(__\_(____)         )"
+		LR"(      _  _ _  _ ____ ____ ____    __    ____ ____ __  __ _ ____     __  __ _ _  _ _  _  __ ____ ____                    )"
+		LR"(     / )( / )( (  __(  _ (  __)  (  )  / ___(_  _/ _\(  ( (    \   / _\(  ( ( \/ ( \/ )/  (  _ (  __)                   )"
+		LR"(     \ /\ ) __ () _) )   /) _)    )(   \___ \ )(/    /    /) D (  /    /    /)  // \/ (  O )   /) _) _                  )"
+		LR"(     (_/\_\_)(_(____(__\_(____)  (__)  (____/(__\_/\_\_)__(____/  \_/\_\_)__(__/ \_)(_/\__(__\_(____(_)                 )"
+		LR"(                                                                                                                        )"
+		LR"(                                                                                                                        )"
+		LR"(                                                    controls                                                            )"
+		LR"(                                    wasd - to move            arrows - to look                                          )"
+		LR"(                                                                                                                        )"
+		LR"(                                                                                                                        )"
+		LR"(                                               press enter to start                                                     )"
+		LR"(                                                                                                                        )"
+		LR"(                                                                                                                        )";
+
+	// the art is laid out for 120 columns, other widths center it and cut off what does not fit
+	const int messageWidth = 120;
+	const int messageRows = (int)wcslen(message) / messageWidth;
+	const int screenXOffset = (SCREEN_DIMENSIONS.X - messageWidth) / 2;
+
+	wmemset(screen, L' ', SCREEN_DIMENSIONS.X * SCREEN_DIMENSIONS.Y);
+	for (int y = 0; y < std::min(messageRows, SCREEN_DIMENSIONS.Y); y++)
+		for (int x = std::max(0, -screenXOffset); x < std::min(messageWidth, SCREEN_DIMENSIONS.X - screenXOffset); x++)
+			screen[y * SCREEN_DIMENSIONS.X + x + screenXOffset] = message[y * messageWidth + x];
+}
+
+
+void GenerateMaze(Maze& maze, const Vector2n& mazeDimensions, const unsigned int seed)
+{
+	maze.SetAlgorithm(_mazeAlgorithm);
+	maze.SetDistanceFieldEnabled(_useDistanceField);
+	maze.Generate(mazeDimensions.X, mazeDimensions.Y, seed);
+}
+
+void GameInit(const Maze& maze, GameWorld& world)
+{
+	// renderer, collisions and the map overlay all read the maze's own grid
+	world.Map = maze.GetMap().GetView();
+	world.Clearance = maze.IsDistanceFieldEnabled() ? maze.GetDistanceField().GetView() : DistanceFieldView {};
+	world.PathToExit = maze.IsFlowFieldEnabled() ? maze.GetFlowField().GetView() : FlowFieldView {};
+	world.MapDimensions = { maze.GetMapWidth(), maze.GetMapHeight() };
+	world.MapOrigin = { 0, 0 };
+	world.HasExit = true;
+	world.ExitPos = maze.GetExitPos();
+	world.StartPos = maze.GetStartPos();
+	world.MapRevision++;
+}
+
+void GameInitFromFile(const MazeFile& file, GameWorld& world)
+{
+	const MazeFileContents& contents = file.GetContents();
+
+	// views into the mapped pages, nothing is copied, only the cells a frame reads get paged in
+	world.Map = contents.Map;
+	world.Clearance = _useDistanceField ? contents.Clearance : DistanceFieldView {};
+	world.PathToExit = contents.PathToExit;
+	world.MapDimensions = { contents.Map.Width, contents.Map.Height };
+	world.MapOrigin = { 0, 0 };
+	world.HasExit = true;
+	world.ExitPos = contents.ExitPos;
+	world.StartPos = contents.StartPos;
+	world.MapRevision++;
+}
+
+static void SetChunkWindow(const ChunkedWorld& chunks, GameWorld& world)
+{
+	world.Map = chunks.GetWindow();
+	world.MapDimensions = { world.Map.Width, world.Map.Height };
+	world.MapOrigin = chunks.GetWindowOrigin();
+	world.MapRevision++;
+}
+
+void GameInitChunked(ChunkedWorld& chunks, const unsigned int seed, GameWorld& world)
+{
+	chunks.Reset(seed);
+
+	world.Clearance = DistanceFieldView {};
+	world.PathToExit = FlowFieldView {};
+	world.HasExit = false;
+	world.ExitPos = { 0, 0 };
+	SetChunkWindow(chunks, world);
+	world.StartPos = chunks.GetStartPos() - world.MapOrigin;
+}
+
+void PlayerInit(const GameWorld& world, PlayerState& player)
+{
+	player.Pos = Vector2f(world.StartPos) + Vector2f(0.5f, 0.5f);
+	player.Angle = -PI / 2;
+	player.FOV = PI / 4.0f;
+
+	player.MapIsVisible = false;
+	player.InDebug = false;
+}
+
+void UpdateChunkedWorld(ChunkedWorld& chunks, GameWorld& world, PlayerState& player)
+{
+	const Vector2n origin = world.MapOrigin;
+	if (!chunks.Recenter(origin.X + (int)floorf(player.Pos.X), origin.Y + (int)floorf(player.Pos.Y)))
+		return;
+
+	SetChunkWindow(chunks, world);
+
+	// the player stays in window cells, which keeps floats small however far the walk goes
+	player.Pos -= Vector2f((float)(world.MapOrigin.X - origin.X), (float)(world.MapOrigin.Y - origin.Y));
+}
+
+void SetScreenDimensions(int width, int height)
+{
+	SCREEN_DIMENSIONS.X = std::clamp(width, MIN_SCREEN_DIMENSIONS.X, MAX_SCREEN_DIMENSIONS.X);
+	SCREEN_DIMENSIONS.Y = std::clamp(height, MIN_SCREEN_DIMENSIONS.Y, MAX_SCREEN_DIMENSIONS.Y);
+}
+
+void SetRayReuse(bool enabled)
+{
+	_reuseRays = enabled;
+}
+
+void SetMazeAlgorithm(MazeAlgorithm algorithm)
+{
+	_mazeAlgorithm = algorithm;
+}
+
+void SetDistanceFieldRaycasting(bool enabled)
+{
+	_useDistanceField = enabled;
+}
+
+bool WriteFrame(wchar_t* screen, ThreadPool& renderPool, RenderBuffers& buffers, const GameWorld& world, const PlayerState& player,
+	float elapsedTime, float latencyMs)
+{
+	if ((int)buffers.RayDistances.size() != SCREEN_DIMENSIONS.X)
+	{
+		buffers.RayDirX.resize(SCREEN_DIMENSIONS.X);
+		buffers.RayDirY.resize(SCREEN_DIMENSIONS.X);
+		buffers.RayDistances.resize(SCREEN_DIMENSIONS.X);
+		// sized for the full width so changing the ray count never allocates
+		buffers.SampleDirX.resize(SCREEN_DIMENSIONS.X);
+		buffers.SampleDirY.resize(SCREEN_DIMENSIONS.X);
+		buffers.SampleDistances.resize(SCREEN_DIMENSIONS.X);
+		buffers.Columns.resize(SCREEN_DIMENSIONS.X * SCREEN_DIMENSIONS.Y);
+	}
+
+	const int rays = buffers.RenderColumns > 0
+		? std::clamp(buffers.RenderColumns, 2, SCREEN_DIMENSIONS.X)
+		: SCREEN_DIMENSIONS.X;
+
+	bool tablesRebuilt = buffers.Tables.Update(SCREEN_DIMENSIONS.X, SCREEN_DIMENSIONS.Y, player.FOV, MAX_RENDERING_DISTANCE);
+	RayCastRange castRange = ReuseCachedRays(buffers, world, player, tablesRebuilt, rays);
+
+	// a single captured pointer fits std::function's small buffer, so handing out tiles does not allocate
+	struct { wchar_t* Screen; RenderBuffers* Buffers; const GameWorld* World; Vector2f ViewPos; Vector2f ViewDir; RayCastRange CastRange; int Rays; } tileJob
+		{ screen, &buffers, &world, player.Pos, { cosf(castRange.ViewAngle), sinf(castRange.ViewAngle) }, castRange, rays };
+	auto* job = &tileJob;
+
+	{
+		PROFILE_STAGE(FrameStage::Raycast);
+
+		const int renderTileCount = (SCREEN_DIMENSIONS.X + RENDER_TILE_COLUMNS - 1) / RENDER_TILE_COLUMNS;
+		if (rays == SCREEN_DIMENSIONS.X)
+		{
+			renderPool.ParallelFor(renderTileCount, [job](int tile)
+			{
+				RenderBuffers& buffers = *job->Buffers;
+				WriteColumnTile(job->Screen, buffers.Columns.data(), tile, buffers.Tables, job->ViewPos, job->ViewDir,
+					job->CastRange.FirstColumn, job->CastRange.ColumnCount, job->CastRange.ColumnsDrawn, buffers.RayDirX.data(), buffers.RayDirY.data(), buffers.RayDistances.data(), job->World->Map, job->World->Clearance);
+			});
+		}
+		else
+		{
+			// a tile blends samples from both of its sides, so every sample is cast before any tile is drawn
+			if (castRange.ColumnCount > 0)
+			{
+				const int sampleTileCount = (rays + RENDER_TILE_COLUMNS - 1) / RENDER_TILE_COLUMNS;
+				renderPool.ParallelFor(sampleTileCount, [job](int tile)
+				{
+					RenderBuffers& buffers = *job->Buffers;
+					int firstSample = tile * RENDER_TILE_COLUMNS;
+					CastSampleRays(firstSample, std::min<int>(RENDER_TILE_COLUMNS, job->Rays - firstSample), job->Rays, buffers.Tables, job->ViewPos, job->ViewDir,
+						buffers.SampleDirX.data(), buffers.SampleDirY.data(), buffers.SampleDistances.data(), job->World->Map, job->World->Clearance);
+				});
+			}
+
+			renderPool.ParallelFor(renderTileCount, [job](int tile)
+			{
+				RenderBuffers& buffers = *job->Buffers;
+				if (!job->CastRange.ColumnsDrawn)
+				{
+					int firstColumn = tile * RENDER_TILE_COLUMNS;
+					ReconstructColumnDistances(firstColumn, std::min<int>(RENDER_TILE_COLUMNS, SCREEN_DIMENSIONS.X - firstColumn), job->Rays,
+						buffers.Tables, buffers.SampleDistances.data(), buffers.RayDistances.data());
+				}
+				WriteColumnTile(job->Screen, buffers.Columns.data(), tile, buffers.Tables, job->ViewPos, job->ViewDir,
+					0, 0, job->CastRange.ColumnsDrawn, buffers.RayDirX.data(), buffers.RayDirY.data(), buffers.RayDistances.data(), job->World->Map, job->World->Clearance);
+			});
+		}
+	}
+
+	PROFILE_STAGE(FrameStage::Overlays);
+
+	float distanceToEnd;
+	GetDistancesToEnd(world, &player.Pos.X, &player.Pos.Y, 1, &distanceToEnd);
+
+	if (world.HasExit)
+		WriteProgressToEnd(screen, 0, distanceToEnd);
+	if (player.MapIsVisible)
+	{
+		// below the progress bar
+		buffers.MapOverlay.Write(screen, SCREEN_DIMENSIONS.X, 0, 1, SCREEN_DIMENSIONS.X, SCREEN_DIMENSIONS.Y - 1,
+			world.Map, world.MapRevision, player.Pos);
+		if (world.HasExit && world.PathToExit.Cells)
+			WriteHint(screen, 0, 9, world.PathToExit, player);
+	}
+	if (player.InDebug)
+	{
+		WriteDebugMessage(screen, SCREEN_DIMENSIONS.Y - 1, world.MapOrigin, player, elapsedTime, latencyMs, distanceToEnd);
+#if PROFILER_ENABLED
+		WriteProfilerStats(screen, SCREEN_DIMENSIONS.Y - 1);
+#endif
+	}
+
+	return world.HasExit && distanceToEnd <= 0.0f;
+}
\ No newline at end of file
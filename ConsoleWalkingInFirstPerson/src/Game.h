@@ -0,0 +1,132 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Vector2.h"
+#include "Maze.h"
+#include "OccupancyGrid.h"
+#include "ThreadPool.h"
+#include "RenderTables.h"
+#include "Minimap.h"
+#include "ChunkedWorld.h"
+#include "MazeFile.h"
+
+// set once at startup through SetScreenDimensions, before anything is sized from it
+extern Vector2n SCREEN_DIMENSIONS;
+const Vector2n MAZE_DIMENSIONS { 6, 6 };
+// the one maze every player of a server shares, big enough for them to spread out
+const Vector2n SERVER_MAZE_DIMENSIONS { 32, 32 };
+
+// the overlays need this much room, past the maximum a frame stops fitting in any terminal
+const Vector2n MIN_SCREEN_DIMENSIONS { 64, 20 };
+const Vector2n MAX_SCREEN_DIMENSIONS { 1024, 512 };
+
+// keys of one frame, toggles are true only on the frame their key went down
+struct InputState
+{
+	bool MoveForwards;
+	bool MoveBackwards;
+	bool MoveLeft;
+	bool MoveRight;
+	bool RotateLeft;
+	bool RotateRight;
+	bool ToggleMap;
+	bool ToggleDebug;
+};
+
+// everything one player changes, a game with many players keeps one of these each and shares the world
+struct PlayerState
+{
+	// in Map cells
+	Vector2f Pos;
+	float Angle = 0.0f;
+	float FOV = 0.0f;
+	bool MapIsVisible = false;
+	bool InDebug = false;
+};
+
+// what a running game reads from its maze, the maze has to outlive it
+struct GameWorld
+{
+	OccupancyView Map;
+	// Clearance is nullptr unless the maze was generated with its distance field
+	DistanceFieldView Clearance;
+	// Cells is nullptr unless the maze was generated with its flow field, progress falls back to manhattan distance
+	FlowFieldView PathToExit;
+	Vector2n MapDimensions;
+	// world cell of Map's 0, 0, only a chunked world moves it, player position is relative to it
+	Vector2n MapOrigin;
+	// false in a chunked world, ExitPos means nothing then and the game never ends
+	bool HasExit = true;
+	Vector2n ExitPos;
+	// where PlayerInit puts a player
+	Vector2n StartPos;
+	// bumped by GameInit, renderer caches built on an older map are thrown away
+	int MapRevision = 0;
+};
+
+// per frame scratch of the renderer, sized on first use
+struct RenderBuffers
+{
+	std::vector<float> RayDirX;
+	std::vector<float> RayDirY;
+	std::vector<float> RayDistances;
+	// rays actually cast per frame, 0 - one per screen column,
+	// otherwise columns between two rays are reconstructed from their distances
+	int RenderColumns = 0;
+	std::vector<float> SampleDirX;
+	std::vector<float> SampleDirY;
+	std::vector<float> SampleDistances;
+	// column-major back buffer, each column is SCREEN_DIMENSIONS.Y contiguous cells
+	std::vector<wchar_t> Columns;
+	RenderTables Tables;
+	Minimap MapOverlay;
+
+	// pose RayDistances were cast from, the next frame reuses them when only the angle changed
+	bool RaysCached = false;
+	Vector2f CachedPos;
+	float CachedAngle = 0.0f;
+	int CachedMapRevision = 0;
+	int CachedRenderColumns = 0;
+	// player angle on the last frame, to tell when turning stopped
+	float LastPlayerAngle = 0.0f;
+};
+
+// clamps to MIN_SCREEN_DIMENSIONS and MAX_SCREEN_DIMENSIONS
+void SetScreenDimensions(int width, int height);
+
+// with the SetMazeAlgorithm and SetDistanceFieldRaycasting settings, safe on any thread once they are set
+void GenerateMaze(Maze& maze, const Vector2n& mazeDimensions, const unsigned int seed);
+// the GameInit functions only set up the world, PlayerInit then puts a player at its start
+// only points the world at the maze, which has to be generated already and outlive the game
+void GameInit(const Maze& maze, GameWorld& world);
+// renders straight from the file's mapped pages, file has to stay open while the game runs,
+// its distance field is only used with SetDistanceFieldRaycasting
+void GameInitFromFile(const MazeFile& file, GameWorld& world);
+// endless world of ChunkedWorld chunks instead of a single maze
+void GameInitChunked(ChunkedWorld& chunks, const unsigned int seed, GameWorld& world);
+void PlayerInit(const GameWorld& world, PlayerState& player);
+// call after HandleInput, keeps the chunk window centered on the player, a chunked world has one player only
+void UpdateChunkedWorld(ChunkedWorld& chunks, GameWorld& world, PlayerState& player);
+void HandleInput(const GameWorld& world, PlayerState& player, const InputState& input, float elapsedTime);
+// the walking and turning of HandleInput for count walkers at once, each field in an array of its own
+void MoveWalkers(const OccupancyView& map, const InputState* inputs, const int count, const float elapsedTime,
+	float* posX, float* posY, float* angles);
+// how far along the way to the exit each walker still has to go, 0 on the exit, 1 at the far end or in a world without one
+void GetDistancesToEnd(const GameWorld& world, const float* posX, const float* posY, const int count, float* distances);
+
+// on by default, off re-casts every column every frame
+void SetRayReuse(bool enabled);
+// DepthFirst by default, takes effect on the next GenerateMaze
+void SetMazeAlgorithm(MazeAlgorithm algorithm);
+// off by default, takes effect on the next GenerateMaze, rays skip empty space using the maze's distance field
+void SetDistanceFieldRaycasting(bool enabled);
+
+// draws the view and the overlays, returns true once the player stands at the exit,
+// latencyMs is how long the last presented frame took from reading input to reaching the terminal
+// only reads the world, so players of one world may be drawn on different threads at once, each with their own buffers
+bool WriteFrame(wchar_t* screen, ThreadPool& renderPool, RenderBuffers& buffers, const GameWorld& world, const PlayerState& player,
+	float elapsedTime, float latencyMs);
+void WriteGameOver(wchar_t* screen);
+void WriteStartMenu(wchar_t* screen);
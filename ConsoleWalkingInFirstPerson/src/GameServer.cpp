@@ -0,0 +1,313 @@
+#include "GameServer.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "FramePacer.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// bytes taken from a connection per read, a tick's worth of keys fits many times over
+const int SESSION_READ_SIZE = 256;
+
+static void SetNonBlocking(const int fd)
+{
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+
+GameServer::Session::Session(const int fd)
+	:	Fd(fd), Player(), Buffers(), Screen((size_t)SCREEN_DIMENSIONS.X * SCREEN_DIMENSIONS.Y, L' '),
+		Encoder(SCREEN_DIMENSIONS.X, SCREEN_DIMENSIONS.Y, -1), Output(AnsiTerminal::ENTER_SEQUENCE), OutputSent(0),
+		Keys(), Decoder(), Pressed(), GameOver(false), Closed(false),
+		FrameSent(false), FrameSkipped(false), BytesSent(0)
+{}
+
+
+GameServer::GameServer(const GameWorld& world, ThreadPool& pool, const int targetFps, const int renderColumns)
+	:	_world(world), _pool(pool), _sessionPool(1), TARGET_FPS(targetFps), RENDER_COLUMNS(renderColumns),
+		_listenFd(-1), _socketPath(), _stopping(false),
+		_pendingMutex(), _pendingFds(), _sessions(), _pollFds(), _tickElapsedTime(0.0f),
+		_statsMutex(), _stats()
+{}
+
+GameServer::~GameServer()
+{
+	for (auto& session : _sessions)
+		_Close(*session);
+
+	std::lock_guard<std::mutex> lock(_pendingMutex);
+	for (int fd : _pendingFds)
+		close(fd);
+
+	if (_listenFd >= 0)
+	{
+		close(_listenFd);
+		unlink(_socketPath.c_str());
+	}
+}
+
+bool GameServer::Listen(const char* socketPath)
+{
+	sockaddr_un address {};
+	address.sun_family = AF_UNIX;
+	if (strlen(socketPath) >= sizeof(address.sun_path))
+		return false;
+	strcpy(address.sun_path, socketPath);
+
+	// a socket left behind by a server that did not get to clean up, anything else at the path is kept
+	struct stat existing;
+	if (lstat(socketPath, &existing) == 0 && S_ISSOCK(existing.st_mode))
+		unlink(socketPath);
+
+	_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (_listenFd < 0)
+		return false;
+
+	if (bind(_listenFd, (const sockaddr*)&address, sizeof(address)) != 0 || listen(_listenFd, SOMAXCONN) != 0)
+	{
+		close(_listenFd);
+		_listenFd = -1;
+		return false;
+	}
+
+	SetNonBlocking(_listenFd);
+	_socketPath = socketPath;
+	return true;
+}
+
+void GameServer::AddConnection(const int fd)
+{
+	std::lock_guard<std::mutex> lock(_pendingMutex);
+	_pendingFds.push_back(fd);
+}
+
+void GameServer::Run()
+{
+	// a player hanging up halfway through a frame must not take the server down
+	signal(SIGPIPE, SIG_IGN);
+
+	FramePacer pacer(TARGET_FPS);
+	auto lastTickTime = std::chrono::steady_clock::now();
+
+	while (!_stopping.load())
+	{
+		auto tickStart = std::chrono::steady_clock::now();
+		_tickElapsedTime = std::chrono::duration<float>(tickStart - lastTickTime).count();
+		lastTickTime = tickStart;
+
+		_Tick();
+
+		std::chrono::duration<double, std::milli> tickTime = std::chrono::steady_clock::now() - tickStart;
+		{
+			std::lock_guard<std::mutex> lock(_statsMutex);
+			_stats.TickCount++;
+			_stats.TotalTickMs += tickTime.count();
+			_stats.MaxTickMs = std::max(_stats.MaxTickMs, tickTime.count());
+		}
+
+		pacer.Wait();
+	}
+}
+
+void GameServer::Stop()
+{
+	_stopping.store(true);
+}
+
+GameServerStats GameServer::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(_statsMutex);
+	return _stats;
+}
+
+void GameServer::ResetStats()
+{
+	std::lock_guard<std::mutex> lock(_statsMutex);
+	int sessionCount = _stats.SessionCount;
+	_stats = {};
+	_stats.SessionCount = sessionCount;
+}
+
+void GameServer::_Tick()
+{
+	_AcceptConnections();
+	_ReadInput();
+
+	// sessions that hung up or left go before anything is rendered for them
+	for (auto& session : _sessions)
+		if (session->Closed)
+			_Close(*session);
+	_sessions.erase(std::remove_if(_sessions.begin(), _sessions.end(),
+		[](const std::unique_ptr<Session>& session) { return session->Fd < 0; }), _sessions.end());
+
+	// one session per task, a frame is too small to be worth splitting once there are a few players
+	GameServer* server = this;
+	_pool.ParallelFor((int)_sessions.size(), [server](int i) { server->_StepSession(*server->_sessions[i]); });
+
+	std::lock_guard<std::mutex> lock(_statsMutex);
+	_stats.SessionCount = (int)_sessions.size();
+	for (auto& session : _sessions)
+	{
+		_stats.FramesSent += session->FrameSent;
+		_stats.FramesSkipped += session->FrameSkipped;
+		_stats.BytesSent += session->BytesSent;
+	}
+}
+
+void GameServer::_AcceptConnections()
+{
+	if (_listenFd >= 0)
+	{
+		int fd;
+		while ((fd = accept(_listenFd, nullptr, nullptr)) >= 0)
+			AddConnection(fd);
+	}
+
+	std::lock_guard<std::mutex> lock(_pendingMutex);
+	for (int fd : _pendingFds)
+	{
+		SetNonBlocking(fd);
+
+		std::unique_ptr<Session> session(new Session(fd));
+		session->Buffers.RenderColumns = RENDER_COLUMNS;
+		PlayerInit(_world, session->Player);
+		_sessions.push_back(std::move(session));
+	}
+	_pendingFds.clear();
+}
+
+void GameServer::_ReadInput()
+{
+	_pollFds.resize(_sessions.size());
+	for (size_t i = 0; i < _sessions.size(); i++)
+		_pollFds[i] = { _sessions[i]->Fd, POLLIN, 0 };
+
+	if (_pollFds.empty() || poll(_pollFds.data(), (nfds_t)_pollFds.size(), 0) < 0)
+		return;
+
+	unsigned char bytes[SESSION_READ_SIZE];
+	for (size_t i = 0; i < _sessions.size(); i++)
+	{
+		Session& session = *_sessions[i];
+		auto press = [&session](Key code) { session.Pressed[(int)code] |= session.Keys.Apply({ code, true }); };
+
+		// a whole tick went by without the rest of a cut off sequence
+		if (_pollFds[i].revents == 0)
+		{
+			if (session.Decoder.HasPending())
+				session.Decoder.Flush(press);
+			continue;
+		}
+
+		while (true)
+		{
+			ssize_t count = read(session.Fd, bytes, sizeof(bytes));
+			if (count < 0 && errno == EINTR)
+				continue;
+			if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+				break;
+			// end of stream or a broken connection
+			if (count <= 0)
+			{
+				session.Decoder.Flush(press);
+				session.Closed = true;
+				break;
+			}
+
+			session.Decoder.Decode(bytes, (int)count, press);
+		}
+	}
+}
+
+void GameServer::_StepSession(Session& session)
+{
+	session.FrameSent = false;
+	session.FrameSkipped = false;
+	session.BytesSent = 0;
+
+	// the last frame is still queued, a new one would only pile up behind it
+	if (!_Flush(session))
+	{
+		session.FrameSkipped = !session.Closed;
+		return;
+	}
+
+	InputState input = session.Keys.GetFrameInput(session.Pressed);
+	const bool restart = session.Pressed[(int)Key::Enter], leave = session.Pressed[(int)Key::Escape];
+	std::fill(session.Pressed, session.Pressed + KEY_COUNT, false);
+
+	if (leave)
+	{
+		session.Closed = true;
+		return;
+	}
+
+	// the game over screen stays as it was sent until the player starts again
+	if (session.GameOver)
+	{
+		if (!restart)
+			return;
+
+		PlayerInit(_world, session.Player);
+		session.GameOver = false;
+	}
+
+	HandleInput(_world, session.Player, input, _tickElapsedTime);
+	session.GameOver = WriteFrame(session.Screen.data(), _sessionPool, session.Buffers, _world, session.Player, _tickElapsedTime, 0.0f);
+	if (session.GameOver)
+		WriteGameOver(session.Screen.data());
+
+	session.Output.clear();
+	session.OutputSent = 0;
+	session.Encoder.EncodeFrame(session.Screen.data(), session.Output);
+	session.FrameSent = true;
+
+	_Flush(session);
+}
+
+bool GameServer::_Flush(Session& session)
+{
+	while (session.OutputSent < session.Output.size())
+	{
+		ssize_t sent = send(session.Fd, session.Output.data() + session.OutputSent, session.Output.size() - session.OutputSent, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return false;
+		if (sent <= 0)
+		{
+			session.Closed = true;
+			return false;
+		}
+
+		session.OutputSent += (size_t)sent;
+		session.BytesSent += (size_t)sent;
+	}
+	return !session.Closed;
+}
+
+void GameServer::_Close(Session& session)
+{
+	if (session.Fd < 0)
+		return;
+
+	// best effort, the terminal is put back if the connection still takes it
+	send(session.Fd, AnsiTerminal::EXIT_SEQUENCE, strlen(AnsiTerminal::EXIT_SEQUENCE), MSG_NOSIGNAL | MSG_DONTWAIT);
+	close(session.Fd);
+	session.Fd = -1;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <poll.h>
+
+#include "Game.h"
+#include "Input.h"
+#include "AnsiTerminal.h"
+#include "ThreadPool.h"
+
+struct GameServerStats
+{
+	int SessionCount;
+	long long TickCount;
+	// reading input, rendering and sending, the pacer's sleep is left out
+	double TotalTickMs;
+	double MaxTickMs;
+	// rendered and handed to the connection, a frame where nothing changed is sent as zero bytes
+	long long FramesSent;
+	// frames not rendered because the connection still had the session's last one queued
+	long long FramesSkipped;
+	long long BytesSent;
+};
+
+// many players walking one shared world, each on their own connection to a terminal
+// every tick reads every connection, renders all sessions across the pool, one session per task,
+// and streams each one only what changed since the last frame it got
+class GameServer
+{
+public:
+	// the world is only read and has to outlive the server, renderColumns as RenderBuffers::RenderColumns
+	GameServer(const GameWorld& world, ThreadPool& pool, const int targetFps, const int renderColumns);
+	~GameServer();
+
+	GameServer(const GameServer&) = delete;
+	GameServer& operator=(const GameServer&) = delete;
+
+	// unix socket players connect to, e.g. with socat -,raw,echo=0 UNIX-CONNECT:path
+	bool Listen(const char* socketPath);
+	// an already connected stream socket, the server owns it from now on, safe on any thread
+	void AddConnection(const int fd);
+
+	// ticks until Stop
+	void Run();
+	// safe on any thread and in a signal handler
+	void Stop();
+
+	GameServerStats GetStats() const;
+	void ResetStats();
+
+private:
+	struct Session
+	{
+		int Fd;
+		PlayerState Player;
+		RenderBuffers Buffers;
+		std::vector<wchar_t> Screen;
+		// never writes, only encodes the diff into Output
+		AnsiTerminal Encoder;
+		std::string Output;
+		size_t OutputSent;
+
+		KeyTracker Keys;
+		TerminalKeyDecoder Decoder;
+		// fresh presses since the last tick, indexed by Key
+		bool Pressed[KEY_COUNT];
+		// standing on the exit, enter plays again
+		bool GameOver;
+		bool Closed;
+
+		// what the last tick did, summed up by the server thread
+		bool FrameSent;
+		bool FrameSkipped;
+		size_t BytesSent;
+
+		Session(const int fd);
+	};
+
+	const GameWorld& _world;
+	ThreadPool& _pool;
+	// sessions render inside a pool task, their tiles run inline on this one
+	ThreadPool _sessionPool;
+	const int TARGET_FPS;
+	const int RENDER_COLUMNS;
+
+	int _listenFd;
+	std::string _socketPath;
+	std::atomic<bool> _stopping;
+
+	// connections added from other threads, picked up at the start of a tick
+	std::mutex _pendingMutex;
+	std::vector<int> _pendingFds;
+
+	std::vector<std::unique_ptr<Session>> _sessions;
+	std::vector<pollfd> _pollFds;
+	float _tickElapsedTime;
+
+	mutable std::mutex _statsMutex;
+	GameServerStats _stats;
+
+	void _Tick();
+	void _AcceptConnections();
+	void _ReadInput();
+	void _StepSession(Session& session);
+	// sends what is left of Output, false while some of it is still queued or the connection is gone
+	bool _Flush(Session& session);
+	void _Close(Session& session);
+};
+
+#endif
\ No newline at end of file
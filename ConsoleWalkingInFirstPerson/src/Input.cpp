@@ -0,0 +1,350 @@
+#include "Input.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#endif
+
+// how long the reader thread sleeps before it looks at the stop flag again, only matters on exit
+const int READ_TIMEOUT_MS = 100;
+
+#ifndef _WIN32
+// an escape with nothing after it for this long is the escape key, not the start of a sequence split across reads
+const int ESCAPE_TIMEOUT_MS = 25;
+// longer sequences than any key the game reads are dropped instead of waited on
+const int MAX_ESCAPE_SEQUENCE_LENGTH = 16;
+#endif
+
+#ifdef _WIN32
+const bool KEYS_REPORT_RELEASE = true;
+#else
+// terminals send a key again on autorepeat but never say it was let go
+const bool KEYS_REPORT_RELEASE = false;
+#endif
+// without release reports a fresh key counts as held this long, longer than the terminal waits before it starts repeating
+const std::chrono::milliseconds KEY_FIRST_REPEAT_HOLD_TIME(700);
+// after the first repeat, until a second one shows how fast the terminal repeats
+const std::chrono::milliseconds KEY_REPEAT_HOLD_TIME(150);
+// then it is let go once a repeat is this much later than twice the gap between the last two
+const std::chrono::milliseconds KEY_REPEAT_SLACK(50);
+
+
+#ifdef _WIN32
+
+static Key KeyFromVirtualKey(const WORD virtualKey)
+{
+	switch (virtualKey)
+	{
+	case 'W':			return Key::W;
+	case 'A':			return Key::A;
+	case 'S':			return Key::S;
+	case 'D':			return Key::D;
+	case 'M':			return Key::M;
+	case VK_LEFT:		return Key::Left;
+	case VK_RIGHT:		return Key::Right;
+	case VK_DELETE:		return Key::Delete;
+	// VK_RETURN is 'enter' key
+	case VK_RETURN:		return Key::Enter;
+	case VK_ESCAPE:		return Key::Escape;
+	default:			return Key::None;
+	}
+}
+
+void InputReader::_ReadLoop()
+{
+	HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+	INPUT_RECORD records[32];
+
+	while (!_stopping.load())
+	{
+		DWORD wait = WaitForSingleObject(input, READ_TIMEOUT_MS);
+		if (wait == WAIT_TIMEOUT)
+			continue;
+
+		DWORD count = 0;
+		if (wait != WAIT_OBJECT_0 || !ReadConsoleInputW(input, records, 32, &count))
+			break;
+
+		for (DWORD i = 0; i < count; i++)
+		{
+			if (records[i].EventType != KEY_EVENT)
+				continue;
+
+			const KEY_EVENT_RECORD& keyEvent = records[i].Event.KeyEvent;
+			Key code = KeyFromVirtualKey(keyEvent.wVirtualKeyCode);
+			if (code != Key::None)
+				_Push(code, keyEvent.bKeyDown != FALSE);
+		}
+	}
+}
+
+#else
+
+static Key KeyFromChar(const unsigned char c)
+{
+	switch (c)
+	{
+	case 'w': case 'W':		return Key::W;
+	case 'a': case 'A':		return Key::A;
+	case 's': case 'S':		return Key::S;
+	case 'd': case 'D':		return Key::D;
+	case 'm': case 'M':		return Key::M;
+	case '\r': case '\n':	return Key::Enter;
+	default:				return Key::None;
+	}
+}
+
+// arrows and delete come as escape sequences, an escape with nothing after it is the key itself
+int DecodeTerminalKey(const unsigned char* bytes, const int count, const bool inputEnds, Key& key)
+{
+	key = Key::None;
+	if (bytes[0] != 0x1B)
+	{
+		key = KeyFromChar(bytes[0]);
+		return 1;
+	}
+
+	if (count < 2 && !inputEnds)
+		return 0;
+	if (count < 2 || (bytes[1] != '[' && bytes[1] != 'O'))
+	{
+		key = Key::Escape;
+		return 1;
+	}
+
+	// CSI / SS3: parameters then one final byte in 0x40..0x7E
+	int end = 2;
+	while (end < count && end < MAX_ESCAPE_SEQUENCE_LENGTH && !(bytes[end] >= 0x40 && bytes[end] <= 0x7E))
+		end++;
+	// a sequence that never ends is garbage, not something to wait for
+	if (end == MAX_ESCAPE_SEQUENCE_LENGTH)
+		return end;
+	if (end == count)
+		return inputEnds ? count : 0;
+
+	if (bytes[end] == 'C')
+		key = Key::Right;
+	else if (bytes[end] == 'D')
+		key = Key::Left;
+	else if (bytes[end] == '~' && end == 3 && bytes[2] == '3')
+		key = Key::Delete;
+
+	return end + 1;
+}
+
+TerminalKeyDecoder::TerminalKeyDecoder()
+	:	_pending()
+{}
+
+void TerminalKeyDecoder::Decode(const unsigned char* bytes, const int count, const std::function<void(Key)>& onKey)
+{
+	_pending.insert(_pending.end(), bytes, bytes + count);
+	_DecodePending(false, onKey);
+}
+
+void TerminalKeyDecoder::Flush(const std::function<void(Key)>& onKey)
+{
+	_DecodePending(true, onKey);
+}
+
+bool TerminalKeyDecoder::HasPending() const
+{
+	return !_pending.empty();
+}
+
+void TerminalKeyDecoder::_DecodePending(const bool inputEnds, const std::function<void(Key)>& onKey)
+{
+	int decoded = 0;
+	const int count = (int)_pending.size();
+	while (decoded < count)
+	{
+		Key code;
+		int used = DecodeTerminalKey(_pending.data() + decoded, count - decoded, inputEnds, code);
+		if (used == 0)
+			break;
+		decoded += used;
+		if (code != Key::None)
+			onKey(code);
+	}
+	// keeps its capacity, so steady input does not allocate
+	_pending.erase(_pending.begin(), _pending.begin() + decoded);
+}
+
+void InputReader::_ReadLoop()
+{
+	unsigned char bytes[64];
+	auto push = [this](Key code) { _Push(code, true); };
+
+	while (!_stopping.load())
+	{
+		pollfd input { STDIN_FILENO, POLLIN, 0 };
+		int ready = poll(&input, 1, _decoder.HasPending() ? ESCAPE_TIMEOUT_MS : READ_TIMEOUT_MS);
+		if (ready == 0)
+		{
+			_decoder.Flush(push);
+			continue;
+		}
+		if (ready < 0 && errno == EINTR)
+			continue;
+		if (ready < 0)
+			break;
+
+		ssize_t count = read(STDIN_FILENO, bytes, sizeof(bytes));
+		if (count < 0 && (errno == EINTR || errno == EAGAIN))
+			continue;
+		// readable but empty is end of input, e.g. the terminal went away
+		if (count <= 0)
+			break;
+
+		_decoder.Decode(bytes, (int)count, push);
+	}
+
+	_decoder.Flush(push);
+}
+
+#endif
+
+
+KeyTracker::KeyTracker()
+	:	_held(), _lastDown(), _repeating(), _repeatGaps()
+{}
+
+bool KeyTracker::Apply(const KeyEvent& event)
+{
+	const int key = (int)event.Code;
+	const auto now = std::chrono::steady_clock::now();
+
+	bool wasHeld = _IsStillHeld(key, now);
+
+	if (event.Down)
+	{
+		// the first repeat only ends the terminal's delay, the gap after it is the repeat rate
+		_repeatGaps[key] = wasHeld && _repeating[key] ? now - _lastDown[key] : std::chrono::steady_clock::duration::zero();
+		_repeating[key] = wasHeld;
+		_lastDown[key] = now;
+	}
+	_held[key] = event.Down;
+	return event.Down && !wasHeld;
+}
+
+bool KeyTracker::_IsStillHeld(const int key, const std::chrono::steady_clock::time_point now) const
+{
+	if (!_held[key] || KEYS_REPORT_RELEASE)
+		return _held[key];
+
+	const auto quiet = now - _lastDown[key];
+	if (!_repeating[key])
+		return quiet <= KEY_FIRST_REPEAT_HOLD_TIME;
+	if (_repeatGaps[key] == std::chrono::steady_clock::duration::zero())
+		return quiet <= KEY_REPEAT_HOLD_TIME;
+	return quiet <= _repeatGaps[key] * 2 + KEY_REPEAT_SLACK;
+}
+
+InputState KeyTracker::GetFrameInput(const bool* pressed)
+{
+	const auto now = std::chrono::steady_clock::now();
+	auto isHeld = [&](Key code)
+	{
+		const int key = (int)code;
+		// pressed and let go between two frames still moves the player for one frame
+		if (pressed[key])
+			return true;
+		_held[key] = _IsStillHeld(key, now);
+		return _held[key];
+	};
+
+	InputState input {};
+
+	input.MoveForwards = isHeld(Key::W);
+	input.MoveBackwards = isHeld(Key::S);
+	input.MoveRight = isHeld(Key::D);
+	input.MoveLeft = isHeld(Key::A);
+
+	input.RotateLeft = isHeld(Key::Left);
+	input.RotateRight = isHeld(Key::Right);
+
+	input.ToggleMap = pressed[(int)Key::M];
+	input.ToggleDebug = pressed[(int)Key::Delete];
+
+	return input;
+}
+
+
+InputReader::InputReader()
+	:	_events(), _wakeMutex(), _wakeUp(), _stopping(false), _closed(false), _thread(), _keys()
+{
+	_thread = std::thread([this]()
+	{
+		_ReadLoop();
+
+		// nothing more will come, wake whoever is waiting for a key
+		{
+			std::lock_guard<std::mutex> lock(_wakeMutex);
+			_closed.store(true);
+		}
+		_wakeUp.notify_all();
+	});
+}
+
+InputReader::~InputReader()
+{
+	_stopping.store(true);
+	_thread.join();
+}
+
+void InputReader::_Push(Key code, bool down)
+{
+	if (!_events.Push({ code, down }))
+		return;
+
+	// taking the lock orders the push before a waiter's check of the queue, so the wake-up is never lost
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+	}
+	_wakeUp.notify_one();
+}
+
+bool InputReader::IsClosed() const
+{
+	return _closed.load();
+}
+
+Key InputReader::WaitForKeyDown()
+{
+	while (true)
+	{
+		KeyEvent event;
+		while (_events.Pop(event))
+		{
+			_keys.Apply(event);
+			if (event.Down)
+				return event.Code;
+		}
+
+		std::unique_lock<std::mutex> lock(_wakeMutex);
+		_wakeUp.wait(lock, [this]() { return !_events.IsEmpty() || _closed.load(); });
+		if (_events.IsEmpty())
+			return Key::Escape;
+	}
+}
+
+void InputReader::DiscardEvents()
+{
+	KeyEvent event;
+	while (_events.Pop(event))
+		_keys.Apply(event);
+}
+
+InputState InputReader::ReadFrameInput()
+{
+	bool pressed[KEY_COUNT] = {};
+
+	KeyEvent event;
+	while (_events.Pop(event))
+		pressed[(int)event.Code] |= _keys.Apply(event);
+
+	return _keys.GetFrameInput(pressed);
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Game.h"
+#include "SpscQueue.h"
+
+enum class Key : unsigned char { None, W, A, S, D, Left, Right, M, Delete, Enter, Escape };
+const int KEY_COUNT = 11;
+
+struct KeyEvent
+{
+	Key Code;
+	// false - released, only reported where the platform knows about releases
+	bool Down;
+};
+
+// keys held by one keyboard, fed its events in the order they came
+class KeyTracker
+{
+public:
+	KeyTracker();
+
+	// true for a fresh press, false for autorepeat and releases
+	bool Apply(const KeyEvent& event);
+	// keys held now, toggles are the keys set in pressed, which is indexed by Key
+	InputState GetFrameInput(const bool* pressed);
+
+private:
+	bool _held[KEY_COUNT];
+	std::chrono::steady_clock::time_point _lastDown[KEY_COUNT];
+	// without release reports, whether the terminal started repeating a held key and how far apart its last two repeats were
+	bool _repeating[KEY_COUNT];
+	std::chrono::steady_clock::duration _repeatGaps[KEY_COUNT];
+
+	bool _IsStillHeld(const int key, const std::chrono::steady_clock::time_point now) const;
+};
+
+#ifndef _WIN32
+// decodes one key from the start of terminal input, returns how many bytes it took, key is None for bytes the game ignores,
+// 0 for an escape sequence cut off at the end unless inputEnds, then a lone escape is the key itself and the rest is dropped
+int DecodeTerminalKey(const unsigned char* bytes, const int count, const bool inputEnds, Key& key);
+
+// reads can split an escape sequence, the cut off end waits here for the bytes after it
+class TerminalKeyDecoder
+{
+public:
+	TerminalKeyDecoder();
+
+	// calls onKey for every key the bytes complete, after whatever the last call left undecoded
+	void Decode(const unsigned char* bytes, const int count, const std::function<void(Key)>& onKey);
+	// nothing followed the undecoded end in time, so it is taken as it is
+	void Flush(const std::function<void(Key)>& onKey);
+	bool HasPending() const;
+
+private:
+	std::vector<unsigned char> _pending;
+
+	void _DecodePending(const bool inputEnds, const std::function<void(Key)>& onKey);
+};
+#endif
+
+// reads the keyboard on its own thread, which sleeps in the OS until a key arrives,
+// and hands key events to the game thread through a lock-free queue
+// on unix the terminal has to be in raw mode already, AnsiTerminal does that
+class InputReader
+{
+public:
+	InputReader();
+	~InputReader();
+
+	InputReader(const InputReader&) = delete;
+	InputReader& operator=(const InputReader&) = delete;
+
+	// sleeps until a key goes down and returns it, Escape once input is closed
+	Key WaitForKeyDown();
+	// drops every queued event, e.g. keys pressed while a screen was not listening
+	void DiscardEvents();
+	// takes every event queued since the last call, keys held now and toggles pressed since then
+	InputState ReadFrameInput();
+	// true once the reader saw the end of input, no key will arrive after the queued ones
+	bool IsClosed() const;
+
+private:
+	SpscQueue<KeyEvent, 256> _events;
+
+	// the queue itself never locks, this only lets the game thread sleep while it is empty
+	std::mutex _wakeMutex;
+	std::condition_variable _wakeUp;
+
+	std::atomic<bool> _stopping;
+	std::atomic<bool> _closed;
+	std::thread _thread;
+
+	// game thread side
+	KeyTracker _keys;
+#ifndef _WIN32
+	// reader thread side
+	TerminalKeyDecoder _decoder;
+#endif
+
+	void _ReadLoop();
+	void _Push(Key code, bool down);
+};
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "InputTrace.h"
+
+#include <fstream>
+#include <sstream>
+
+static bool SameInput(const InputState& lhs, const InputState& rhs)
+{
+	return	lhs.MoveForwards == rhs.MoveForwards && lhs.MoveBackwards == rhs.MoveBackwards &&
+			lhs.MoveLeft == rhs.MoveLeft && lhs.MoveRight == rhs.MoveRight &&
+			lhs.RotateLeft == rhs.RotateLeft && lhs.RotateRight == rhs.RotateRight &&
+			lhs.ToggleMap == rhs.ToggleMap && lhs.ToggleDebug == rhs.ToggleDebug;
+}
+
+static bool SetKey(InputState& input, const std::string& key)
+{
+	if (key == "W")				input.MoveForwards = true;
+	else if (key == "S")		input.MoveBackwards = true;
+	else if (key == "A")		input.MoveLeft = true;
+	else if (key == "D")		input.MoveRight = true;
+	else if (key == "LEFT")		input.RotateLeft = true;
+	else if (key == "RIGHT")	input.RotateRight = true;
+	else if (key == "M")		input.ToggleMap = true;
+	else if (key == "DELETE")	input.ToggleDebug = true;
+	else						return false;
+	return true;
+}
+
+bool ParseInputTrace(const std::string& text, std::vector<InputTraceSegment>& trace)
+{
+	trace.clear();
+
+	std::istringstream lines(text);
+	std::string line;
+	while (std::getline(lines, line))
+	{
+		line = line.substr(0, line.find('#'));
+
+		std::istringstream tokens(line);
+		InputTraceSegment segment {};
+		if (!(tokens >> segment.FrameCount))
+		{
+			// empty and comment lines are fine, anything else is not
+			if (line.find_first_not_of(" \t\r") != std::string::npos)
+				return false;
+			continue;
+		}
+
+		std::string key;
+		while (tokens >> key)
+			if (!SetKey(segment.Input, key))
+				return false;
+
+		if (segment.FrameCount <= 0)
+			return false;
+
+		trace.push_back(segment);
+	}
+
+	return !trace.empty();
+}
+
+bool LoadInputTrace(const char* path, std::vector<InputTraceSegment>& trace)
+{
+	std::ifstream file(path);
+	if (!file)
+		return false;
+
+	std::stringstream text;
+	text << file.rdbuf();
+	return ParseInputTrace(text.str(), trace);
+}
+
+bool SaveInputTrace(const char* path, const std::vector<InputTraceSegment>& trace)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	file << "# frames keys\n";
+	for (const InputTraceSegment& segment : trace)
+	{
+		const InputState& input = segment.Input;
+		file << segment.FrameCount;
+		if (input.MoveForwards)		file << " W";
+		if (input.MoveBackwards)	file << " S";
+		if (input.MoveLeft)			file << " A";
+		if (input.MoveRight)		file << " D";
+		if (input.RotateLeft)		file << " LEFT";
+		if (input.RotateRight)		file << " RIGHT";
+		if (input.ToggleMap)		file << " M";
+		if (input.ToggleDebug)		file << " DELETE";
+		file << '\n';
+	}
+
+	return (bool)file;
+}
+
+InputState GetTraceInput(const std::vector<InputTraceSegment>& trace, int frameIndex)
+{
+	for (const InputTraceSegment& segment : trace)
+	{
+		if (frameIndex < segment.FrameCount)
+		{
+			InputState input = segment.Input;
+			if (frameIndex != 0)
+				input.ToggleMap = input.ToggleDebug = false;
+			return input;
+		}
+		frameIndex -= segment.FrameCount;
+	}
+
+	InputState input = trace.back().Input;
+	input.ToggleMap = input.ToggleDebug = false;
+	return input;
+}
+
+int GetTraceFrameCount(const std::vector<InputTraceSegment>& trace)
+{
+	int frameCount = 0;
+	for (const InputTraceSegment& segment : trace)
+		frameCount += segment.FrameCount;
+	return frameCount;
+}
+
+void InputTraceRecorder::Record(const InputState& input)
+{
+	// toggles always start their own segment so they fire on its first frame only
+	bool hasToggle = input.ToggleMap || input.ToggleDebug;
+	if (!hasToggle && !_trace.empty() && SameInput(_trace.back().Input, input))
+		_trace.back().FrameCount++;
+	else
+		_trace.push_back({ 1, input });
+}
+
+const std::vector<InputTraceSegment>& InputTraceRecorder::GetTrace() const { return _trace; }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Game.h"
+
+// run of identical frames of input
+struct InputTraceSegment
+{
+	int FrameCount;
+	InputState Input;
+};
+
+// text form, one segment per line: <frame count> [W] [A] [S] [D] [LEFT] [RIGHT] [M] [DELETE]
+// M and DELETE toggle on the first frame of their segment only, '#' starts a comment
+bool ParseInputTrace(const std::string& text, std::vector<InputTraceSegment>& trace);
+bool LoadInputTrace(const char* path, std::vector<InputTraceSegment>& trace);
+bool SaveInputTrace(const char* path, const std::vector<InputTraceSegment>& trace);
+
+// input of frame frameIndex, trace has to be non-empty, frames past its end repeat the last segment without toggles
+InputState GetTraceInput(const std::vector<InputTraceSegment>& trace, int frameIndex);
+int GetTraceFrameCount(const std::vector<InputTraceSegment>& trace);
+
+// collects a live game's input frame by frame
+class InputTraceRecorder
+{
+public:
+	void Record(const InputState& input);
+	const std::vector<InputTraceSegment>& GetTrace() const;
+
+private:
+	std::vector<InputTraceSegment> _trace;
+};
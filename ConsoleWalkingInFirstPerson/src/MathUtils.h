@@ -0,0 +1,37 @@
+#pragma once
+
+const float PI = 3.14159f;
+
+// one map cell in each FlowStep direction, opposite steps are two apart and turning right goes one step up
+const int STEP_X[4] = { 1, 0, -1, 0 };
+const int STEP_Y[4] = { 0, 1, 0, -1 };
+
+// splitmix64 finalizer, inputs one bit apart come out unrelated
+inline unsigned int MixHash(unsigned long long hash)
+{
+	hash ^= hash >> 30; hash *= 0xBF58476D1CE4E5B9ull;
+	hash ^= hash >> 27; hash *= 0x94D049BB133111EBull;
+	hash ^= hash >> 31;
+	return (unsigned int)hash;
+}
+
+// seed of the index-th of many streams drawn from one seed, neighbouring indices get unrelated seeds
+inline unsigned int HashSeed(const unsigned int seed, const unsigned int index)
+{
+	return MixHash(seed * 0x9E3779B97F4A7C15ull ^ index * 0xC2B2AE3D27D4EB4Full);
+}
+
+// xorshift32, hot loops draw many numbers and rand() is a locked libc call
+inline unsigned int NextRandom(unsigned int& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+// xorshift gets stuck on 0
+inline unsigned int ToRandomState(const unsigned int seed)
+{
+	return seed != 0 ? seed : 1;
+}
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include "Maze.h"
+#include "MazeFile.h"
+#include "ThreadPool.h"
+#include "MathUtils.h"
 
 #include <vector>
-#include <stack>
+#include <algorithm>
+#include <cstdlib>
 
 enum class Direction { Left = 0, Up = 1, Right = 2, Down = 3 };
 
@@ -16,137 +20,366 @@ static Vector2n DirectionToVector2n(const Direction dir)
 	}
 }
 
-static bool InMazeBounds(const Vector2n& pos, const int width, const int height)
+// seeded from rand() so srand still decides which maze comes out
+static unsigned int SeedRandom()
 {
-	return 0 <= pos.X && pos.X < width && 0 <= pos.Y && pos.Y < height;
+	return ((unsigned int)rand() << 16) ^ (unsigned int)rand() ^ 0x9E3779B9u;
 }
 
-static bool Contains(const std::vector<Vector2n> vec, const Vector2n& pos)
+// union-find root with path halving
+static int FindSet(std::vector<int>& parents, int set)
 {
-	return std::find(vec.begin(), vec.end(), pos) != vec.end();
+	while (parents[set] != set)
+	{
+		parents[set] = parents[parents[set]];
+		set = parents[set];
+	}
+	return set;
 }
 
-static Vector2n MazePosToMapPos(const Vector2n& mazePosition)
+// depth first walk over the maze cells [left, left + width) x [top, top + height) from start,
+// carves passages straight into the map as it goes and never opens a wall on the region's edge
+static void CarveRegion(OccupancyGrid& map, const int left, const int top, const int width, const int height,
+	const Vector2n& start, unsigned int& randomState, std::vector<bool>& visited, std::vector<Vector2n>& breadcrumbs)
 {
-	return { mazePosition.X * 2 + 1, mazePosition.Y * 2 + 1 };
-}
+	// same order as Direction, kept as plain ints so the hot loop does no Vector2n calls
+	const int OFFSET_X[4] = { -1, 0, 1, 0 };
+	const int OFFSET_Y[4] = { 0, 1, 0, -1 };
 
-static int MazePosToMapIndex(const Vector2n& mazePosition, const int width)
-{
-	Vector2n mazePos = MazePosToMapPos(mazePosition);
-	return mazePos.X * width + mazePos.Y;
+	const int regionSize = width * height;
+
+	visited.assign(regionSize, false);
+	breadcrumbs.clear();
+
+	visited[(start.Y - top) * width + (start.X - left)] = true;
+	map.SetWall(start.X * 2 + 1, start.Y * 2 + 1, false);
+	breadcrumbs.push_back(start);
+
+	int visitedCount = 1;
+	int availableDirections[4];
+
+	while (visitedCount < regionSize)
+	{
+		const Vector2n currentPos = breadcrumbs.back();
+
+		int availableCount = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			const int x = currentPos.X + OFFSET_X[i] - left, y = currentPos.Y + OFFSET_Y[i] - top;
+			if (0 <= x && x < width && 0 <= y && y < height && !visited[y * width + x])
+				availableDirections[availableCount++] = i;
+		}
+
+		if (availableCount != 0)
+		{
+			const int dir = availableDirections[NextRandom(randomState) % availableCount];
+			const int nextX = currentPos.X + OFFSET_X[dir], nextY = currentPos.Y + OFFSET_Y[dir];
+
+			visited[(nextY - top) * width + (nextX - left)] = true;
+			visitedCount++;
+
+			// cell and the wall between it and the previous one
+			const int mapX = nextX * 2 + 1, mapY = nextY * 2 + 1;
+			map.SetWall(mapX, mapY, false);
+			map.SetWall(mapX - OFFSET_X[dir], mapY - OFFSET_Y[dir], false);
+
+			breadcrumbs.push_back({ nextX, nextY });
+		}
+		else
+		{
+			breadcrumbs.pop_back();
+		}
+	}
 }
 
-static Vector2n PointBetween(const Vector2n& lhs, const Vector2n& rhs)
+static Vector2n MazePosToMapPos(const Vector2n& mazePosition)
 {
-	return { (lhs.X + rhs.X) / 2, (lhs.Y + rhs.Y) / 2 };
+	return { mazePosition.X * 2 + 1, mazePosition.Y * 2 + 1 };
 }
 
 
 Maze::Maze()
-	:	MAZE_WIDTH(0), MAZE_HEIGHT(0), MAP_WIDTH(0), MAP_HEIGHT(0), 
-		_mazePath(), _map(),
-		_endMapPosition(), _startMapPosition()
+	:	MAZE_WIDTH(0), MAZE_HEIGHT(0), _mazeStartPosition(),
+		MAP_WIDTH(0), MAP_HEIGHT(0), _map(),
+		_startMapPosition(), _endMapPosition(), _seed(0),
+		_algorithm(MazeAlgorithm::DepthFirst), _distanceFieldEnabled(false), _distanceField(),
+		_flowFieldEnabled(true), _flowField(),
+		_visited(), _breadcrumbs(),
+		_rowSets(), _setParents(), _setCellCounts(), _setDownCells(), _setGoesDown(), _cellGoesDown(), _mapRow(),
+		_tileSeams(), _tileParents()
 {}
 
 Maze::~Maze() {}
 
 void Maze::Generate(const int width, const int height)
+{
+	Generate(width, height, SeedRandom());
+}
+
+void Maze::Generate(const int width, const int height, const unsigned int seed)
+{
+	if (_algorithm == MazeAlgorithm::Eller)
+	{
+		OccupancyGridRowSink sink(_map);
+		GenerateRows(width, height, seed, sink);
+	}
+	else if (_algorithm == MazeAlgorithm::Tiled)
+	{
+		MAZE_WIDTH = width; MAZE_HEIGHT = height;
+		MAP_WIDTH = width * 2 + 1;  MAP_HEIGHT = height * 2 + 1;
+
+		_CarveTiles(seed, DEFAULT_TILE_SIZE, nullptr);
+	}
+	else
+	{
+		MAZE_WIDTH = width; MAZE_HEIGHT = height;
+		MAP_WIDTH = width * 2 + 1;  MAP_HEIGHT = height * 2 + 1;
+
+		_seed = seed;
+		unsigned int randomState = ToRandomState(seed);
+		_mazeStartPosition = _GenerateMazeStartPosition(randomState);
+		_CarveMap(randomState);
+		_endMapPosition = _GenerateMapEndPosition();
+		_startMapPosition = _GenerateMapStartPosition(randomState);
+
+		_map.SetWall(_endMapPosition.X, _endMapPosition.Y, false);
+	}
+
+	if (_distanceFieldEnabled)
+		_distanceField.Build(_map);
+	if (_flowFieldEnabled)
+		_flowField.Build(_map, &_endMapPosition, 1);
+}
+
+void Maze::Carve(const int width, const int height, const unsigned int seed)
 {
 	MAZE_WIDTH = width; MAZE_HEIGHT = height;
 	MAP_WIDTH = width * 2 + 1;  MAP_HEIGHT = height * 2 + 1;
 
-	_mazePath = _GenerateMazePath();
-	_map = _GenerateMap();
-	_endMapPosition = _GenerateMapEndPosition();
-	_startMapPosition = _GenerateMapStartPosition();
-	
-	_map[_endMapPosition.Y * MAP_WIDTH + _endMapPosition.X] = '.';
+	_seed = seed;
+	unsigned int randomState = ToRandomState(seed);
+	_mazeStartPosition = { (int)(NextRandom(randomState) % width), (int)(NextRandom(randomState) % height) };
+	_CarveMap(randomState);
+	_startMapPosition = _endMapPosition = MazePosToMapPos(_mazeStartPosition);
+
+	if (_distanceFieldEnabled)
+		_distanceField.Build(_map);
 }
 
-std::vector<Vector2n> Maze::_GenerateMazePath()
+// on the border, the exit is cut next to it
+Vector2n Maze::_GenerateMazeStartPosition(unsigned int& randomState)
 {
-	const int mazeSize = MAZE_WIDTH * MAZE_HEIGHT;
-	Vector2n start = (int)(rand() % 2) == 1
-		? Vector2n((int)(rand() % MAZE_WIDTH), (int)(rand() % 2 * (MAZE_HEIGHT - 1)))
-		: Vector2n((int)(rand() % 2 * (MAZE_WIDTH - 1)), (int)(rand() % MAZE_HEIGHT));
+	const bool onTopOrBottom = NextRandom(randomState) & 1;
+	const int along = (int)(NextRandom(randomState) % (onTopOrBottom ? MAZE_WIDTH : MAZE_HEIGHT));
+	const int side = (int)(NextRandom(randomState) & 1);
+	return onTopOrBottom
+		? Vector2n(along, side * (MAZE_HEIGHT - 1))
+		: Vector2n(side * (MAZE_WIDTH - 1), along);
+}
 
-	std::vector<Vector2n> visited(mazeSize, { -1, -1 });
-	int visitedCount = 0;
-	visited[visitedCount++] = start;
+// depth first walk that carves passages straight into the map as it goes
+void Maze::_CarveMap(unsigned int& randomState)
+{
+	_map.Reset(MAP_WIDTH, MAP_HEIGHT, true);
+	CarveRegion(_map, 0, 0, MAZE_WIDTH, MAZE_HEIGHT, _mazeStartPosition, randomState, _visited, _breadcrumbs);
+}
 
-	std::stack<Vector2n> breadcrumbs;
-	breadcrumbs.push(start);
+void Maze::GenerateTiled(const int width, const int height, const unsigned int seed, const int tileSize, ThreadPool* pool)
+{
+	MAZE_WIDTH = width; MAZE_HEIGHT = height;
+	MAP_WIDTH = width * 2 + 1;  MAP_HEIGHT = height * 2 + 1;
 
+	_CarveTiles(seed, tileSize, pool);
 
-	Vector2n currentPos = start;
-	bool availableDirections[4];
+	if (_distanceFieldEnabled)
+		_distanceField.Build(_map);
+	if (_flowFieldEnabled)
+		_flowField.Build(_map, &_endMapPosition, 1);
+}
+
+void Maze::_CarveTiles(const unsigned int seed, const int tileSize, ThreadPool* pool)
+{
+	// a multiple of 4 maze cells is a multiple of 8 map cells, so no two tiles ever write the same occupancy word
+	const int tile = std::max(4, (tileSize + 3) / 4 * 4);
+	const int tilesX = (MAZE_WIDTH + tile - 1) / tile, tilesY = (MAZE_HEIGHT + tile - 1) / tile;
+	const int tileCount = tilesX * tilesY;
+
+	_seed = seed;
+	_map.Reset(MAP_WIDTH, MAP_HEIGHT, true);
 
-	while (visitedCount < mazeSize)
+	// every tile has its own random stream, so the thread that happens to carve it does not matter
+	auto carveTile = [this, seed, tile, tilesX](int index)
 	{
-		for (size_t i = 0; i < 4; i++)
+		const int left = index % tilesX * tile, top = index / tilesX * tile;
+		const int width = std::min(tile, MAZE_WIDTH - left), height = std::min(tile, MAZE_HEIGHT - top);
+
+		unsigned int randomState = ToRandomState(HashSeed(seed, (unsigned int)index));
+		const Vector2n start { left + (int)(NextRandom(randomState) % width), top + (int)(NextRandom(randomState) % height) };
+
+		std::vector<bool> visited;
+		std::vector<Vector2n> breadcrumbs;
+		CarveRegion(_map, left, top, width, height, start, randomState, visited, breadcrumbs);
+	};
+	if (pool)
+		pool->ParallelFor(tileCount, carveTile);
+	else
+		for (int index = 0; index < tileCount; index++)
+			carveTile(index);
+
+	unsigned int randomState = ToRandomState(seed);
+
+	// each tile is a tree of its cells, opening borders only while they join two trees keeps the whole a tree
+	_tileSeams.clear();
+	for (int tileY = 0; tileY < tilesY; tileY++)
+		for (int tileX = 0; tileX < tilesX; tileX++)
 		{
-			auto posToCheck = currentPos + DirectionToVector2n((Direction)i);
-			availableDirections[i] = !Contains(visited, posToCheck) && InMazeBounds(posToCheck, MAZE_WIDTH, MAZE_HEIGHT);
+			const int index = tileY * tilesX + tileX;
+			const int left = tileX * tile, top = tileY * tile;
+			if (tileX + 1 < tilesX)
+			{
+				const int y = top + (int)(NextRandom(randomState) % std::min(tile, MAZE_HEIGHT - top));
+				_tileSeams.push_back({ index, index + 1, { (left + tile) * 2, y * 2 + 1 } });
+			}
+			if (tileY + 1 < tilesY)
+			{
+				const int x = left + (int)(NextRandom(randomState) % std::min(tile, MAZE_WIDTH - left));
+				_tileSeams.push_back({ index, index + tilesX, { x * 2 + 1, (top + tile) * 2 } });
+			}
 		}
 
-		std::vector<Direction> dirs;
-		for (size_t i = 0; i < 4; i++)
-			if (availableDirections[i])
-				dirs.push_back((Direction)i);
+	for (int i = (int)_tileSeams.size() - 1; i > 0; i--)
+		std::swap(_tileSeams[i], _tileSeams[NextRandom(randomState) % (i + 1)]);
 
-		if (dirs.size() != 0)
-		{
-			Direction dir = dirs[(int)(rand() % dirs.size())];
-			currentPos += DirectionToVector2n(dir);
-			visited[visitedCount++] = currentPos;
-			breadcrumbs.push(currentPos);
-		}
-		else
-		{
-			breadcrumbs.pop();
-			currentPos = breadcrumbs.top();
-		}
+	_tileParents.resize(tileCount);
+	for (int index = 0; index < tileCount; index++)
+		_tileParents[index] = index;
+	for (const TileSeam& seam : _tileSeams)
+	{
+		const int a = FindSet(_tileParents, seam.TileA), b = FindSet(_tileParents, seam.TileB);
+		if (a == b)
+			continue;
+		_tileParents[b] = a;
+		_map.SetWall(seam.MapPos.X, seam.MapPos.Y, false);
 	}
 
-	return visited;
+	_mazeStartPosition = _GenerateMazeStartPosition(randomState);
+	_endMapPosition = _GenerateMapEndPosition();
+	_startMapPosition = _GenerateMapStartPosition(randomState);
+	_map.SetWall(_endMapPosition.X, _endMapPosition.Y, false);
 }
 
-std::wstring Maze::_GenerateMap()
+bool Maze::GenerateRows(const int width, const int height, MazeRowSink& sink)
 {
-	std::wstring map(MAP_WIDTH * MAP_HEIGHT, '#');
+	return GenerateRows(width, height, SeedRandom(), sink);
+}
 
-	std::stack<Vector2n> pathToDraw;
-	pathToDraw.push(_mazePath[0]);
-	map[MazePosToMapIndex(_mazePath[0], MAP_WIDTH)] = '.';
+bool Maze::GenerateRows(const int width, const int height, const unsigned int seed, MazeRowSink& sink)
+{
+	MAZE_WIDTH = width; MAZE_HEIGHT = height;
+	MAP_WIDTH = width * 2 + 1;  MAP_HEIGHT = height * 2 + 1;
+
+	_seed = seed;
+	unsigned int randomState = ToRandomState(seed);
+
+	_mazeStartPosition = { (int)(NextRandom(randomState) % width), 0 };
+	_startMapPosition = MazePosToMapPos(_mazeStartPosition);
+	_endMapPosition = { (int)(NextRandom(randomState) % width) * 2 + 1, MAP_HEIGHT - 1 };
+
+	_rowSets.resize(width);
+	_setParents.resize(width);
+	_setCellCounts.resize(width);
+	_setDownCells.resize(width);
+	_setGoesDown.resize(width);
+	_cellGoesDown.resize(width);
+	_mapRow.assign(MAP_WIDTH, '#');
+
+	sink.Begin(MAP_WIDTH, MAP_HEIGHT);
+	if (!sink.WriteRow(0, _mapRow.data()))
+		return false;
 
-	for (size_t i = 1; i < _mazePath.size(); i++)
+	for (int x = 0; x < width; x++)
+		_rowSets[x] = x;
+
+	for (int y = 0; y < height; y++)
 	{
-		const Vector2n& nextPoint = _mazePath[i];
-		const Vector2n& thisPoint = pathToDraw.top();
-		Vector2n difference = Vector2n::Abs(thisPoint - nextPoint);
-		if ((difference.X + difference.Y) > 1)
+		const bool lastRow = y == height - 1;
+
+		for (int set = 0; set < width; set++)
+			_setParents[set] = set;
+
+		// neighbours in different sets may be joined, on the last row they all have to be
+		std::fill(_mapRow.begin(), _mapRow.end(), '#');
+		for (int x = 0; x < width; x++)
+			_mapRow[x * 2 + 1] = '.';
+		for (int x = 0; x + 1 < width; x++)
 		{
-			pathToDraw.pop();
-			i--;
+			int left = FindSet(_setParents, _rowSets[x]), right = FindSet(_setParents, _rowSets[x + 1]);
+			if (left != right && (lastRow || (NextRandom(randomState) & 0x80000000u)))
+			{
+				_setParents[right] = left;
+				_mapRow[x * 2 + 2] = '.';
+			}
 		}
-		else
+		if (!sink.WriteRow(y * 2 + 1, _mapRow.data()))
+			return false;
+
+		std::fill(_mapRow.begin(), _mapRow.end(), '#');
+		if (lastRow)
 		{
-			auto pointBetween = PointBetween(MazePosToMapPos(thisPoint), MazePosToMapPos(nextPoint));
-			map[pointBetween.Y * MAP_WIDTH + pointBetween.X] = '.';
-			map[MazePosToMapIndex(nextPoint, MAP_WIDTH)] = '.';
+			_mapRow[_endMapPosition.X] = '.';
+			return sink.WriteRow(MAP_HEIGHT - 1, _mapRow.data());
+		}
 
-			pathToDraw.push(nextPoint);
+		// every set goes on down through at least one cell, the forced one is picked uniformly among its cells
+		for (int set = 0; set < width; set++)
+		{
+			_setCellCounts[set] = 0;
+			_setGoesDown[set] = false;
+		}
+		for (int x = 0; x < width; x++)
+		{
+			int set = _rowSets[x] = FindSet(_setParents, _rowSets[x]);
+			_cellGoesDown[x] = (NextRandom(randomState) & 0x80000000u) != 0;
+			_setGoesDown[set] |= _cellGoesDown[x];
+			if (NextRandom(randomState) % ++_setCellCounts[set] == 0)
+				_setDownCells[set] = x;
+		}
+
+		// cells going down keep their set under a new number, the others start sets of their own
+		int nextSet = 0;
+		for (int set = 0; set < width; set++)
+			_setParents[set] = -1;
+		for (int x = 0; x < width; x++)
+		{
+			int set = _rowSets[x];
+			if (!_setGoesDown[set] && _setDownCells[set] == x)
+				_cellGoesDown[x] = true;
+
+			if (_cellGoesDown[x])
+			{
+				if (_setParents[set] < 0)
+					_setParents[set] = nextSet++;
+				_rowSets[x] = _setParents[set];
+				_mapRow[x * 2 + 1] = '.';
+			}
+			else
+				_rowSets[x] = -1;
 		}
+		for (int x = 0; x < width; x++)
+			if (_rowSets[x] < 0)
+				_rowSets[x] = nextSet++;
+
+		if (!sink.WriteRow(y * 2 + 2, _mapRow.data()))
+			return false;
 	}
 
-	return map;
+	return true;
 }
 
 Vector2n Maze::_GenerateMapEndPosition()
 {
-	const Vector2n& startMazePoint = _mazePath[0];
-	Vector2n endMapPosition = MazePosToMapPos(_mazePath[0]);
+	const Vector2n& startMazePoint = _mazeStartPosition;
+	Vector2n endMapPosition = MazePosToMapPos(_mazeStartPosition);
 
 	if (startMazePoint.X == 0)
 		endMapPosition += DirectionToVector2n(Direction::Left);
@@ -160,12 +393,12 @@ Vector2n Maze::_GenerateMapEndPosition()
 	return endMapPosition;
 }
 
-Vector2n Maze::_GenerateMapStartPosition()
+Vector2n Maze::_GenerateMapStartPosition(unsigned int& randomState)
 {
 	Vector2n mazeMiddlePoint = { MAZE_WIDTH / 2, MAZE_HEIGHT / 2 };
 
-	int xInArea = (int)rand() % mazeMiddlePoint.X;
-	int yInArea = (int)rand() % mazeMiddlePoint.Y;
+	int xInArea = (int)(NextRandom(randomState) % mazeMiddlePoint.X);
+	int yInArea = (int)(NextRandom(randomState) % mazeMiddlePoint.Y);
 
 	Vector2n startPos	{ xInArea + (mazeMiddlePoint.X * _endMapPosition.X < mazeMiddlePoint.X ? 1 : 0),
 						  yInArea + (mazeMiddlePoint.Y * _endMapPosition.Y < mazeMiddlePoint.Y ? 1 : 0)};
@@ -175,11 +408,84 @@ Vector2n Maze::_GenerateMapStartPosition()
 
 int Maze::GetMazeWidth() const { return MAZE_WIDTH; }
 int Maze::GetMazeHeight() const { return MAZE_HEIGHT; }
-const std::vector<Vector2n>& Maze::GetMazePath() const { return _mazePath; }
+Vector2n Maze::GetMazeStartPos() const { return _mazeStartPosition; }
 
 int Maze::GetMapWidth() const { return MAP_WIDTH; }
 int Maze::GetMapHeight() const { return MAP_HEIGHT; }
-const std::wstring& Maze::GetMap() const { return _map; }
+const OccupancyGrid& Maze::GetMap() const { return _map; }
 
 Vector2n Maze::GetStartPos() const { return _startMapPosition; }
-Vector2n Maze::GetExitPos() const { return _endMapPosition; }
\ No newline at end of file
+Vector2n Maze::GetExitPos() const { return _endMapPosition; }
+unsigned int Maze::GetSeed() const { return _seed; }
+
+void Maze::SetAlgorithm(MazeAlgorithm algorithm) { _algorithm = algorithm; }
+MazeAlgorithm Maze::GetAlgorithm() const { return _algorithm; }
+
+void Maze::SetDistanceFieldEnabled(bool enabled) { _distanceFieldEnabled = enabled; }
+bool Maze::IsDistanceFieldEnabled() const { return _distanceFieldEnabled; }
+const DistanceField& Maze::GetDistanceField() const { return _distanceField; }
+
+void Maze::SetFlowFieldEnabled(bool enabled) { _flowFieldEnabled = enabled; }
+bool Maze::IsFlowFieldEnabled() const { return _flowFieldEnabled; }
+const FlowField& Maze::GetFlowField() const { return _flowField; }
+
+void Maze::SetWall(int x, int y, bool wall)
+{
+	_map.SetWall(x, y, wall);
+	if (_distanceFieldEnabled)
+		_distanceField.UpdateCell(_map, x, y);
+	// one wall can reroute every path, there is no cheaper update
+	if (_flowFieldEnabled)
+		_flowField.Build(_map, &_endMapPosition, 1);
+}
+
+bool Maze::Save(const char* path) const
+{
+	MazeFileContents contents = {};
+	contents.MazeWidth = MAZE_WIDTH; contents.MazeHeight = MAZE_HEIGHT;
+	contents.Seed = _seed;
+	contents.StartPos = _startMapPosition;
+	contents.ExitPos = _endMapPosition;
+	contents.Map = _map.GetView();
+	// a field is only saved if it was built for this map, Carve does not build the flow field
+	const DistanceFieldView clearance = _distanceField.GetView();
+	if (_distanceFieldEnabled && clearance.Width == MAP_WIDTH && clearance.Height == MAP_HEIGHT)
+		contents.Clearance = clearance;
+	const FlowFieldView pathToExit = _flowField.GetView();
+	if (_flowFieldEnabled && pathToExit.MazeWidth == MAZE_WIDTH && pathToExit.MazeHeight == MAZE_HEIGHT && pathToExit.ExitPos == _endMapPosition)
+		contents.PathToExit = pathToExit;
+
+	return WriteMazeFile(path, contents);
+}
+
+bool Maze::Load(const char* path)
+{
+	MazeFile file;
+	if (!file.Open(path))
+		return false;
+
+	const MazeFileContents& contents = file.GetContents();
+	MAZE_WIDTH = contents.MazeWidth; MAZE_HEIGHT = contents.MazeHeight;
+	MAP_WIDTH = contents.Map.Width; MAP_HEIGHT = contents.Map.Height;
+	_seed = contents.Seed;
+	_startMapPosition = contents.StartPos;
+	_endMapPosition = contents.ExitPos;
+	_mazeStartPosition = { (_startMapPosition.X - 1) / 2, (_startMapPosition.Y - 1) / 2 };
+	_map.Assign(contents.Map);
+
+	if (_distanceFieldEnabled)
+	{
+		if (contents.Clearance.Clearance)
+			_distanceField.Assign(contents.Clearance);
+		else
+			_distanceField.Build(_map);
+	}
+	if (_flowFieldEnabled)
+	{
+		if (contents.PathToExit.Cells)
+			_flowField.Assign(contents.PathToExit);
+		else
+			_flowField.Build(_map, &_endMapPosition, 1);
+	}
+	return true;
+}
\ No newline at end of file
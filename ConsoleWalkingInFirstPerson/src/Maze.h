@@ -4,39 +4,119 @@
 #include <vector>
 
 #include "Vector2.h"
+#include "OccupancyGrid.h"
+#include "DistanceField.h"
+#include "FlowField.h"
+#include "MazeRowSink.h"
+
+// DepthFirst carves the whole maze in memory, Eller builds it one row at a time,
+// Tiled carves depth first tiles independently and joins them, see GenerateTiled
+enum class MazeAlgorithm { DepthFirst, Eller, Tiled };
+
+class ThreadPool;
 
 class Maze
 {
 public:
+	static const int DEFAULT_TILE_SIZE = 64;
+
 	Maze();
 	~Maze();
 
+	// seeded from rand()
 	void Generate(const int width, const int height);
+	// decided by seed alone, the same seed gives the same maze, start and exit, and separate mazes can generate on separate threads
+	void Generate(const int width, const int height, const unsigned int seed);
+	// Eller's algorithm, keeps O(width) state whatever the height and hands every map row to sink
+	// as soon as it is final, the maze's own map is not touched, start is in the top row and the exit
+	// in the bottom wall, returns false when the sink stopped it
+	bool GenerateRows(const int width, const int height, MazeRowSink& sink);
+	bool GenerateRows(const int width, const int height, const unsigned int seed, MazeRowSink& sink);
+	// depth first mazes of tileSize x tileSize cells, carved in parallel on pool or one after another when it is nullptr,
+	// then joined through one opening per tile border picked Kruskal style so the whole is still a perfect maze,
+	// decided by seed and tileSize alone whatever the thread count, tileSize is rounded up to a multiple of 4
+	void GenerateTiled(const int width, const int height, const unsigned int seed, const int tileSize, ThreadPool* pool);
+	// only the depth first passages, decided by seed alone and not by rand(), so separate mazes can carve
+	// on separate threads, start and exit are both left on the cell the walk started from
+	void Carve(const int width, const int height, const unsigned int seed);
+
+	// binary maze file with the map, start, exit and whichever fields are built, see MazeFile
+	bool Save(const char* path) const;
+	// copies a saved maze in so it can be edited, fields the file lacks are built if enabled,
+	// a game that only reads the maze should render straight from a MazeFile instead
+	bool Load(const char* path);
+
+	// DepthFirst by default, Eller makes Generate stream into the maze's own map, Tiled uses DEFAULT_TILE_SIZE on the calling thread
+	void SetAlgorithm(MazeAlgorithm algorithm);
+	MazeAlgorithm GetAlgorithm() const;
 
 	int GetMazeWidth() const;
 	int GetMazeHeight() const;
-	const std::vector<Vector2n>& GetMazePath() const;
+	Vector2n GetMazeStartPos() const;
 
 	int GetMapWidth() const;
 	int GetMapHeight() const;
-	const std::wstring& GetMap() const;
+	const OccupancyGrid& GetMap() const;
 
 	Vector2n GetStartPos() const;
 	Vector2n GetExitPos() const;
+	// seed the maze was generated or carved from
+	unsigned int GetSeed() const;
+
+	// off by default, when on Generate also builds the map's distance field for empty space skipping
+	void SetDistanceFieldEnabled(bool enabled);
+	bool IsDistanceFieldEnabled() const;
+	const DistanceField& GetDistanceField() const;
+
+	// on by default, Generate runs a breadth first search from the exit for path distances and directions
+	void SetFlowFieldEnabled(bool enabled);
+	bool IsFlowFieldEnabled() const;
+	const FlowField& GetFlowField() const;
+
+	// edits one map cell after generation, keeps the distance field in step and rebuilds the flow field
+	void SetWall(int x, int y, bool wall);
 
 private:
 	int MAZE_WIDTH, MAZE_HEIGHT;
-	std::vector<Vector2n> _mazePath;
+	Vector2n _mazeStartPosition;
 
-	// # - wall, . - empty space
 	int MAP_WIDTH, MAP_HEIGHT;
-	std::wstring _map;
+	OccupancyGrid _map;
 
 	Vector2n _startMapPosition;
 	Vector2n _endMapPosition;
+	unsigned int _seed;
+
+	MazeAlgorithm _algorithm;
+	bool _distanceFieldEnabled;
+	DistanceField _distanceField;
+	bool _flowFieldEnabled;
+	FlowField _flowField;
+
+	// scratch space, kept between generations so regenerating a maze of the same size does not allocate
+	std::vector<bool> _visited;
+	std::vector<Vector2n> _breadcrumbs;
+	// Eller's, one entry per maze column or per set, sets are renumbered every row so they stay under the width
+	std::vector<int> _rowSets;
+	std::vector<int> _setParents;
+	std::vector<int> _setCellCounts;
+	std::vector<int> _setDownCells;
+	std::vector<char> _setGoesDown;
+	std::vector<char> _cellGoesDown;
+	std::vector<char> _mapRow;
+	// Tiled, one candidate opening per border between two tiles and the union-find over tiles
+	struct TileSeam
+	{
+		int TileA;
+		int TileB;
+		Vector2n MapPos;
+	};
+	std::vector<TileSeam> _tileSeams;
+	std::vector<int> _tileParents;
 
-	std::vector<Vector2n> _GenerateMazePath();
-	std::wstring _GenerateMap();
-	Vector2n _GenerateMapStartPosition();
+	Vector2n _GenerateMazeStartPosition(unsigned int& randomState);
+	void _CarveMap(unsigned int& randomState);
+	void _CarveTiles(const unsigned int seed, const int tileSize, ThreadPool* pool);
+	Vector2n _GenerateMapStartPosition(unsigned int& randomState);
 	Vector2n _GenerateMapEndPosition();
 };
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "MazeFile.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MAGIC[8] = { 'C', 'W', 'F', 'P', 'M', 'A', 'Z', 'E' };
+// bumped whenever the header or a section changes layout, older files are refused rather than misread
+static const uint32_t VERSION = 1;
+// sections start on page boundaries so each one could be mapped by itself
+static const uint64_t SECTION_ALIGNMENT = 4096;
+static const int MAX_SECTIONS = 8;
+
+// readers skip kinds they do not know
+enum class SectionKind : uint32_t { Occupancy = 1, Clearance = 2, PathToExit = 3 };
+
+struct SectionEntry
+{
+	uint32_t Kind;
+	uint32_t Reserved;
+	uint64_t Offset;
+	uint64_t Bytes;
+};
+
+struct FileHeader
+{
+	char Magic[8];
+	uint32_t Version;
+	uint32_t SectionCount;
+	int32_t MazeWidth, MazeHeight;
+	int32_t MapWidth, MapHeight;
+	int32_t StartX, StartY;
+	int32_t ExitX, ExitY;
+	uint32_t Seed;
+	int32_t MaxPathDistance;
+	SectionEntry Sections[MAX_SECTIONS];
+};
+static_assert(sizeof(FileHeader) == 248, "maze file header layout changed, bump VERSION");
+
+static uint64_t AlignUp(uint64_t offset)
+{
+	return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+static uint64_t GetOccupancyBytes(int mapWidth, int mapHeight)
+{
+	return (uint64_t)((mapWidth + 7) / 8) * ((mapHeight + 7) / 8) * sizeof(uint64_t);
+}
+
+
+bool WriteMazeFile(const char* path, const MazeFileContents& contents)
+{
+	const int mapWidth = contents.Map.Width, mapHeight = contents.Map.Height;
+
+	FileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+	header.Version = VERSION;
+	header.MazeWidth = contents.MazeWidth; header.MazeHeight = contents.MazeHeight;
+	header.MapWidth = mapWidth; header.MapHeight = mapHeight;
+	header.StartX = contents.StartPos.X; header.StartY = contents.StartPos.Y;
+	header.ExitX = contents.ExitPos.X; header.ExitY = contents.ExitPos.Y;
+	header.Seed = contents.Seed;
+
+	const void* sectionData[MAX_SECTIONS];
+	auto addSection = [&](SectionKind kind, const void* data, uint64_t bytes)
+	{
+		uint64_t offset = header.SectionCount == 0 ? AlignUp(sizeof(FileHeader))
+			: AlignUp(header.Sections[header.SectionCount - 1].Offset + header.Sections[header.SectionCount - 1].Bytes);
+		sectionData[header.SectionCount] = data;
+		header.Sections[header.SectionCount++] = { (uint32_t)kind, 0, offset, bytes };
+	};
+
+	addSection(SectionKind::Occupancy, contents.Map.Tiles, GetOccupancyBytes(mapWidth, mapHeight));
+	if (contents.Clearance.Clearance)
+		addSection(SectionKind::Clearance, contents.Clearance.Clearance, (uint64_t)mapWidth * mapHeight);
+	if (contents.PathToExit.Cells)
+	{
+		header.MaxPathDistance = contents.PathToExit.MaxDistance;
+		addSection(SectionKind::PathToExit, contents.PathToExit.Cells,
+			(uint64_t)contents.PathToExit.MazeWidth * contents.PathToExit.MazeHeight * sizeof(uint32_t));
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	uint64_t position = sizeof(header);
+	static const char padding[SECTION_ALIGNMENT] = {};
+	for (uint32_t i = 0; i < header.SectionCount && written; i++)
+	{
+		const SectionEntry& section = header.Sections[i];
+		written = fwrite(padding, 1, (size_t)(section.Offset - position), file) == section.Offset - position
+			&& fwrite(sectionData[i], 1, (size_t)section.Bytes, file) == section.Bytes;
+		position = section.Offset + section.Bytes;
+	}
+
+	return fclose(file) == 0 && written;
+}
+
+
+MazeFile::MazeFile()
+	:	_data(nullptr), _bytes(0), _contents()
+{}
+
+MazeFile::~MazeFile()
+{
+	Close();
+}
+
+bool MazeFile::Open(const char* path)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileBytes;
+	HANDLE mapping = NULL;
+	if (GetFileSizeEx(file, &fileBytes) && (uint64_t)fileBytes.QuadPart >= sizeof(FileHeader))
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	// the view keeps the file and the mapping alive by itself
+	CloseHandle(file);
+	if (mapping == NULL)
+		return false;
+
+	_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!_data)
+		return false;
+	_bytes = (size_t)fileBytes.QuadPart;
+#else
+	int file = open(path, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status;
+	void* data = MAP_FAILED;
+	if (fstat(file, &status) == 0 && (uint64_t)status.st_size >= sizeof(FileHeader))
+		data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	// the mapping keeps the file alive by itself
+	close(file);
+	if (data == MAP_FAILED)
+		return false;
+
+	_data = (const unsigned char*)data;
+	_bytes = (size_t)status.st_size;
+#endif
+
+	if (!_ReadContents())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MazeFile::Close()
+{
+	if (!_data)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(_data);
+#else
+	munmap((void*)_data, _bytes);
+#endif
+	_data = nullptr;
+	_bytes = 0;
+	_contents = MazeFileContents();
+}
+
+// a file that fails here would send the views out of the mapping, so every size is checked against the header
+bool MazeFile::_ReadContents()
+{
+	FileHeader header;
+	memcpy(&header, _data, sizeof(header));
+
+	if (memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0 || header.Version != VERSION || header.SectionCount > MAX_SECTIONS)
+		return false;
+	if (header.MazeWidth <= 0 || header.MazeHeight <= 0
+		|| header.MapWidth != header.MazeWidth * 2 + 1 || header.MapHeight != header.MazeHeight * 2 + 1)
+		return false;
+
+	const int mapWidth = header.MapWidth, mapHeight = header.MapHeight;
+	auto insideMap = [&](int x, int y) { return 0 <= x && x < mapWidth && 0 <= y && y < mapHeight; };
+	if (!insideMap(header.StartX, header.StartY) || !insideMap(header.ExitX, header.ExitY))
+		return false;
+
+	MazeFileContents contents = {};
+	contents.MazeWidth = header.MazeWidth; contents.MazeHeight = header.MazeHeight;
+	contents.Seed = header.Seed;
+	contents.StartPos = { header.StartX, header.StartY };
+	contents.ExitPos = { header.ExitX, header.ExitY };
+
+	for (uint32_t i = 0; i < header.SectionCount; i++)
+	{
+		const SectionEntry& section = header.Sections[i];
+		if (section.Offset % SECTION_ALIGNMENT != 0 || section.Offset > _bytes || section.Bytes > _bytes - section.Offset)
+			return false;
+		const void* data = _data + section.Offset;
+
+		switch ((SectionKind)section.Kind)
+		{
+		case SectionKind::Occupancy:
+			if (section.Bytes != GetOccupancyBytes(mapWidth, mapHeight))
+				return false;
+			contents.Map = { (const uint64_t*)data, mapWidth, mapHeight, (mapWidth + 7) / 8 };
+			break;
+		case SectionKind::Clearance:
+			if (section.Bytes != (uint64_t)mapWidth * mapHeight)
+				return false;
+			contents.Clearance = { (const uint8_t*)data, mapWidth, mapHeight };
+			break;
+		case SectionKind::PathToExit:
+			if (section.Bytes != (uint64_t)header.MazeWidth * header.MazeHeight * sizeof(uint32_t))
+				return false;
+			contents.PathToExit = { (const uint32_t*)data, header.MazeWidth, header.MazeHeight, contents.ExitPos, header.MaxPathDistance };
+			break;
+		}
+	}
+
+	// the grid is the one section a maze cannot do without
+	if (!contents.Map.Tiles)
+		return false;
+
+	_contents = contents;
+	return true;
+}
+
+bool MazeFile::IsOpen() const { return _data != nullptr; }
+const MazeFileContents& MazeFile::GetContents() const { return _contents; }
+size_t MazeFile::GetFileBytes() const { return _bytes; }
\ No newline at end of file
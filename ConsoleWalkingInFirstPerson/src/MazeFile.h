@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "Vector2.h"
+#include "OccupancyGrid.h"
+#include "DistanceField.h"
+#include "FlowField.h"
+
+// binary maze file, a fixed header and page aligned sections holding the grid and fields exactly as they sit in memory,
+// so a mapped file is rendered from without parsing or copying anything, little-endian like every platform the game runs on
+
+// everything a maze file holds, a view with a nullptr was not saved
+struct MazeFileContents
+{
+	int MazeWidth;
+	int MazeHeight;
+	// Maze::Generate with the same seed, size and algorithm gives this maze back
+	unsigned int Seed;
+	Vector2n StartPos;
+	Vector2n ExitPos;
+	OccupancyView Map;
+	DistanceFieldView Clearance;
+	FlowFieldView PathToExit;
+};
+
+// returns false when the file could not be written whole
+bool WriteMazeFile(const char* path, const MazeFileContents& contents);
+
+// read-only mapping of a maze file, pages are read in as the views touch them
+class MazeFile
+{
+public:
+	MazeFile();
+	~MazeFile();
+
+	MazeFile(const MazeFile&) = delete;
+	MazeFile& operator=(const MazeFile&) = delete;
+
+	// checks only the header and the section bounds, false when the file is missing, of another version or cut short
+	bool Open(const char* path);
+	void Close();
+	bool IsOpen() const;
+
+	// views point into the mapping and are valid until Close
+	const MazeFileContents& GetContents() const;
+	size_t GetFileBytes() const;
+
+private:
+	const unsigned char* _data;
+	size_t _bytes;
+	MazeFileContents _contents;
+
+	bool _ReadContents();
+};
\ No newline at end of file
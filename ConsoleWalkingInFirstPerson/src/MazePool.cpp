@@ -0,0 +1,118 @@
+#include "MazePool.h"
+
+#include <algorithm>
+
+#include "MathUtils.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// the game thread and the renderers win every time they want the core, generation fills in the gaps
+static void LowerCurrentThreadPriority()
+{
+#ifdef _WIN32
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__) && defined(SCHED_IDLE)
+	sched_param param {};
+	pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+}
+
+
+MazePool::MazePool(const int capacity, const unsigned int seed, std::function<void(Maze&, unsigned int)> generate)
+	:	CAPACITY(capacity > 0 ? capacity : 1), SEED(seed), _generate(std::move(generate)),
+		_ready(), _recycled(), _generatedCount(0), _stats(),
+		_mutex(), _mazeReady(), _wakeUp(), _stopping(false), _generator()
+{
+	_generator = std::thread(&MazePool::_GeneratorLoop, this);
+}
+
+MazePool::~MazePool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wakeUp.notify_one();
+	_generator.join();
+}
+
+std::unique_ptr<Maze> MazePool::Pop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	_stats.PopCount++;
+	if (_ready.empty())
+	{
+		auto start = std::chrono::steady_clock::now();
+		_mazeReady.wait(lock, [this] { return !_ready.empty(); });
+		std::chrono::duration<double, std::milli> waitTime = std::chrono::steady_clock::now() - start;
+
+		_stats.WaitedPopCount++;
+		_stats.TotalWaitMs += waitTime.count();
+		_stats.MaxWaitMs = std::max(_stats.MaxWaitMs, waitTime.count());
+	}
+
+	std::unique_ptr<Maze> maze = std::move(_ready.front());
+	_ready.pop_front();
+	lock.unlock();
+
+	_wakeUp.notify_one();
+	return maze;
+}
+
+void MazePool::Recycle(std::unique_ptr<Maze> maze)
+{
+	if (!maze)
+		return;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_recycled.push_back(std::move(maze));
+}
+
+MazePoolStats MazePool::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	MazePoolStats stats = _stats;
+	stats.ReadyCount = (int)_ready.size();
+	return stats;
+}
+
+void MazePool::_GeneratorLoop()
+{
+	LowerCurrentThreadPriority();
+
+	while (true)
+	{
+		std::unique_ptr<Maze> maze;
+		unsigned int index;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeUp.wait(lock, [this] { return _stopping || (int)_ready.size() < CAPACITY; });
+			if (_stopping)
+				return;
+
+			if (!_recycled.empty())
+			{
+				maze = std::move(_recycled.back());
+				_recycled.pop_back();
+			}
+			index = _generatedCount++;
+		}
+
+		if (!maze)
+			maze.reset(new Maze());
+		// mazes next to each other in the run get unrelated seeds
+		_generate(*maze, HashSeed(SEED, index));
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_ready.push_back(std::move(maze));
+		}
+		_mazeReady.notify_one();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Maze.h"
+
+struct MazePoolStats
+{
+	// mazes generated and waiting to be played
+	int ReadyCount;
+	int PopCount;
+	// pops that found the pool empty and had to wait for the generator
+	int WaitedPopCount;
+	double TotalWaitMs;
+	double MaxWaitMs;
+};
+
+// upcoming mazes generated on a low priority thread while the current one is played, so a restart only takes one
+// the n-th maze is seeded from the pool's seed and n alone, the same pool seed gives the same run of mazes
+class MazePool
+{
+public:
+	// generate fills a maze from a seed, it runs on the pool's thread and must not touch rand() or anything the game changes
+	MazePool(const int capacity, const unsigned int seed, std::function<void(Maze&, unsigned int)> generate);
+	~MazePool();
+
+	MazePool(const MazePool&) = delete;
+	MazePool& operator=(const MazePool&) = delete;
+
+	// the oldest ready maze, waits for the generator when there is none
+	std::unique_ptr<Maze> Pop();
+	// a maze nothing reads any more, the generator reuses its buffers instead of allocating new ones
+	void Recycle(std::unique_ptr<Maze> maze);
+
+	MazePoolStats GetStats() const;
+
+private:
+	const int CAPACITY;
+	const unsigned int SEED;
+	std::function<void(Maze&, unsigned int)> _generate;
+
+	std::deque<std::unique_ptr<Maze>> _ready;
+	std::vector<std::unique_ptr<Maze>> _recycled;
+	unsigned int _generatedCount;
+	MazePoolStats _stats;
+
+	mutable std::mutex _mutex;
+	// ready grew, for Pop
+	std::condition_variable _mazeReady;
+	// ready shrank or stopping, for the generator
+	std::condition_variable _wakeUp;
+	bool _stopping;
+	std::thread _generator;
+
+	void _GeneratorLoop();
+};
\ No newline at end of file
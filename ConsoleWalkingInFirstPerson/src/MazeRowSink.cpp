@@ -0,0 +1,38 @@
+#include "MazeRowSink.h"
+
+OccupancyGridRowSink::OccupancyGridRowSink(OccupancyGrid& grid)
+	:	_grid(grid)
+{}
+
+OccupancyGridRowSink::~OccupancyGridRowSink() {}
+
+void OccupancyGridRowSink::Begin(const int mapWidth, const int mapHeight)
+{
+	_grid.Reset(mapWidth, mapHeight, true);
+}
+
+bool OccupancyGridRowSink::WriteRow(const int mapY, const char* row)
+{
+	// grid starts out all walls, only the openings need writing
+	for (int x = 0; x < _grid.GetWidth(); x++)
+		if (row[x] != '#')
+			_grid.SetWall(x, mapY, false);
+	return true;
+}
+
+
+TextFileRowSink::TextFileRowSink(FILE* file)
+	:	_file(file), _mapWidth(0)
+{}
+
+TextFileRowSink::~TextFileRowSink() {}
+
+void TextFileRowSink::Begin(const int mapWidth, const int /*mapHeight*/)
+{
+	_mapWidth = mapWidth;
+}
+
+bool TextFileRowSink::WriteRow(const int /*mapY*/, const char* row)
+{
+	return fwrite(row, 1, _mapWidth, _file) == (size_t)_mapWidth && fputc('\n', _file) != EOF;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdio>
+
+#include "OccupancyGrid.h"
+
+// where a streamed maze goes, map rows arrive top to bottom as soon as nothing can change them anymore,
+// only the grid and text file sinks exist, nothing renders or walks a maze while it is still being generated
+class MazeRowSink
+{
+public:
+	virtual ~MazeRowSink() {}
+
+	// called once before the first row
+	virtual void Begin(const int mapWidth, const int mapHeight) = 0;
+	// row is mapWidth cells, # - wall, . - empty space, returning false stops the generation
+	virtual bool WriteRow(const int mapY, const char* row) = 0;
+};
+
+// fills a grid in memory, the whole map has to fit
+class OccupancyGridRowSink : public MazeRowSink
+{
+public:
+	explicit OccupancyGridRowSink(OccupancyGrid& grid);
+	~OccupancyGridRowSink();
+
+	void Begin(const int mapWidth, const int mapHeight) override;
+	bool WriteRow(const int mapY, const char* row) override;
+
+private:
+	OccupancyGrid& _grid;
+};
+
+// the map as text, one line per row, only one row is ever held in memory
+class TextFileRowSink : public MazeRowSink
+{
+public:
+	// file stays open and owned by the caller
+	explicit TextFileRowSink(FILE* file);
+	~TextFileRowSink();
+
+	void Begin(const int mapWidth, const int mapHeight) override;
+	bool WriteRow(const int mapY, const char* row) override;
+
+private:
+	FILE* _file;
+	int _mapWidth;
+};
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Minimap.h"
+
+#include <algorithm>
+#include <bitset>
+
+// walls among the cells of one block, cells past the map edge do not count
+static wchar_t GetBlockGlyph(const OccupancyView& map, int level, int blockX, int blockY)
+{
+	const int x = blockX << level, y = blockY << level;
+	if (level == 0)
+		return map.IsWall(x, y) ? L'#' : L'.';
+
+	const int size = 1 << level;
+	const int columns = std::min(size, map.Width - x), rows = std::min(size, map.Height - y);
+	const uint64_t rowMask = (((uint64_t)1 << columns) - 1) << (x & 7);
+	uint64_t mask = 0;
+	for (int row = 0; row < rows; row++)
+		mask |= rowMask << (((y & 7) + row) << 3);
+
+	const uint64_t tile = map.Tiles[(y >> 3) * map.TilesPerRow + (x >> 3)];
+	const int walls = (int)std::bitset<64>(tile & mask).count(), cells = columns * rows;
+
+	if (walls == 0)					return ' ';
+	else if (walls * 2 < cells)		return 0x2591;
+	else if (walls * 4 < cells * 3)	return 0x2592;
+	else if (walls < cells)			return 0x2593;
+	else							return 0x2588;
+}
+
+// first cell of a window of visible cells out of total, as close to centered on center as the edges allow
+static int GetWindowOrigin(int center, int visible, int total)
+{
+	return std::clamp(center - visible / 2, 0, std::max(0, total - visible));
+}
+
+
+Minimap::Minimap()
+	:	_glyphs(), _tiles(nullptr), _mapRevision(0), _level(0), _originX(0), _originY(0), _columns(0), _rows(0)
+{}
+
+Minimap::~Minimap() {}
+
+void Minimap::Write(wchar_t* screen, int screenWidth, int left, int top, int columns, int rows,
+	const OccupancyView& map, int mapRevision, const Vector2f& playerPos)
+{
+	int level = 0;
+	while (level < MAX_LEVEL && (((map.Width - 1) >> level) + 1 > columns || ((map.Height - 1) >> level) + 1 > rows))
+		level++;
+
+	const int levelWidth = ((map.Width - 1) >> level) + 1, levelHeight = ((map.Height - 1) >> level) + 1;
+	const int playerX = (int)playerPos.X >> level, playerY = (int)playerPos.Y >> level;
+	const int originX = GetWindowOrigin(playerX, columns, levelWidth), originY = GetWindowOrigin(playerY, rows, levelHeight);
+	const int visibleColumns = std::min(columns, levelWidth), visibleRows = std::min(rows, levelHeight);
+
+	if (map.Tiles != _tiles || mapRevision != _mapRevision || level != _level || originX != _originX || originY != _originY
+		|| visibleColumns != _columns || visibleRows != _rows)
+	{
+		_tiles = map.Tiles; _mapRevision = mapRevision; _level = level;
+		_originX = originX; _originY = originY;
+		_columns = visibleColumns; _rows = visibleRows;
+
+		_glyphs.resize((size_t)_columns * _rows);
+		for (int y = 0; y < _rows; y++)
+			for (int x = 0; x < _columns; x++)
+				_glyphs[(size_t)y * _columns + x] = GetBlockGlyph(map, level, originX + x, originY + y);
+	}
+
+	for (int y = 0; y < _rows; y++)
+		std::copy_n(&_glyphs[(size_t)y * _columns], _columns, &screen[(top + y) * screenWidth + left]);
+
+	const int playerColumn = playerX - originX, playerRow = playerY - originY;
+	if (0 <= playerColumn && playerColumn < _columns && 0 <= playerRow && playerRow < _rows)
+		screen[(top + playerRow) * screenWidth + left + playerColumn] = L'P';
+}
+
+int Minimap::GetLevel() const { return _level; }
\ No newline at end of file
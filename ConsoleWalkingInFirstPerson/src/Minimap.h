@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Vector2.h"
+#include "OccupancyGrid.h"
+
+// map overlay that costs the same whatever the size of the map
+// level n draws one glyph per 2^n x 2^n block shaded by how many of its cells are walls, the finest level
+// that fits the overlay is used and maps that do not fit even the coarsest get a window centered on the player
+// blocks of up to 8x8 cells lie inside one occupancy tile, so the grid itself is the pyramid and nothing is built per map
+class Minimap
+{
+public:
+	// a glyph is never coarser than one tile, past that the shades stop telling passages apart
+	static const int MAX_LEVEL = 3;
+
+	Minimap();
+	~Minimap();
+
+	// draws into the columns x rows overlay whose top left cell is left, top of a screen screenWidth wide,
+	// mapRevision has to change whenever the cells of map do
+	void Write(wchar_t* screen, int screenWidth, int left, int top, int columns, int rows,
+		const OccupancyView& map, int mapRevision, const Vector2f& playerPos);
+
+	int GetLevel() const;
+
+private:
+	// glyphs of the last window, refilled only when it moves to another block or the map changes
+	std::vector<wchar_t> _glyphs;
+	const uint64_t* _tiles;
+	int _mapRevision;
+	int _level;
+	int _originX, _originY;
+	int _columns, _rows;
+};
\ No newline at end of file
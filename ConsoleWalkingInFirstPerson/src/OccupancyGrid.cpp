@@ -0,0 +1,44 @@
+#include "OccupancyGrid.h"
+
+OccupancyGrid::OccupancyGrid()
+	:	WIDTH(0), HEIGHT(0), TILES_PER_ROW(0), TILES_PER_COLUMN(0), _tiles()
+{}
+
+OccupancyGrid::~OccupancyGrid() {}
+
+void OccupancyGrid::Reset(const int width, const int height, const bool wall)
+{
+	WIDTH = width; HEIGHT = height;
+	TILES_PER_ROW = (width + 7) / 8; TILES_PER_COLUMN = (height + 7) / 8;
+
+	// padding bits past the map edge get the same value, nobody reads them
+	_tiles.assign((size_t)TILES_PER_ROW * TILES_PER_COLUMN, wall ? ~(uint64_t)0 : 0);
+}
+
+void OccupancyGrid::Assign(const OccupancyView& view)
+{
+	WIDTH = view.Width; HEIGHT = view.Height;
+	TILES_PER_ROW = view.TilesPerRow; TILES_PER_COLUMN = (view.Height + 7) / 8;
+
+	_tiles.assign(view.Tiles, view.Tiles + (size_t)TILES_PER_ROW * TILES_PER_COLUMN);
+}
+
+int OccupancyGrid::GetWidth() const { return WIDTH; }
+int OccupancyGrid::GetHeight() const { return HEIGHT; }
+
+OccupancyView OccupancyGrid::GetView() const
+{
+	return { _tiles.data(), WIDTH, HEIGHT, TILES_PER_ROW };
+}
+
+size_t OccupancyGrid::GetMemoryBytes() const { return _tiles.size() * sizeof(uint64_t); }
+
+std::wstring OccupancyGrid::ToText() const
+{
+	std::wstring text((size_t)WIDTH * HEIGHT, '.');
+	for (int y = 0; y < HEIGHT; y++)
+		for (int x = 0; x < WIDTH; x++)
+			if (IsWall(x, y))
+				text[(size_t)y * WIDTH + x] = '#';
+	return text;
+}
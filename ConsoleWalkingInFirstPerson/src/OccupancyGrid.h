@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// one bit per map cell, set bit - wall
+// cells are packed in 8x8 tiles of one 64 bit word each, so a ray stays inside a few words
+// in any direction and eight neighbouring tiles share a cache line
+
+// non-owning, cheap to copy, valid while the grid it came from is alive and not resized
+struct OccupancyView
+{
+	const uint64_t* Tiles;
+	int Width;
+	int Height;
+	int TilesPerRow;
+
+	bool Contains(int x, int y) const
+	{
+		return 0 <= x && x < Width && 0 <= y && y < Height;
+	}
+
+	// x, y have to be inside the map
+	bool IsWall(int x, int y) const
+	{
+		const uint64_t tile = Tiles[(y >> 3) * TilesPerRow + (x >> 3)];
+		return (tile >> (((y & 7) << 3) | (x & 7))) & 1;
+	}
+};
+
+class OccupancyGrid
+{
+public:
+	OccupancyGrid();
+	~OccupancyGrid();
+
+	// resizes and fills every cell, keeps the allocation when the size does not grow
+	void Reset(const int width, const int height, const bool wall);
+	// copy of another grid's cells, for one that lives outside any grid such as a mapped file
+	void Assign(const OccupancyView& view);
+
+	int GetWidth() const;
+	int GetHeight() const;
+	OccupancyView GetView() const;
+	size_t GetMemoryBytes() const;
+
+	bool IsWall(int x, int y) const
+	{
+		return GetTileWord(x, y) >> GetTileBit(x, y) & 1;
+	}
+
+	void SetWall(int x, int y, bool wall)
+	{
+		const uint64_t mask = (uint64_t)1 << GetTileBit(x, y);
+		uint64_t& tile = _tiles[(size_t)(y >> 3) * TILES_PER_ROW + (x >> 3)];
+		tile = wall ? (tile | mask) : (tile & ~mask);
+	}
+
+	// whole 8x8 tile at once, bit ((y & 7) * 8 + (x & 7)) is cell x, y like in IsWall
+	uint64_t GetTile(int tileX, int tileY) const { return _tiles[(size_t)tileY * TILES_PER_ROW + tileX]; }
+	void SetTile(int tileX, int tileY, uint64_t tile) { _tiles[(size_t)tileY * TILES_PER_ROW + tileX] = tile; }
+
+	// # - wall, . - empty space, row after row
+	std::wstring ToText() const;
+
+private:
+	int WIDTH, HEIGHT;
+	int TILES_PER_ROW, TILES_PER_COLUMN;
+	std::vector<uint64_t> _tiles;
+
+	uint64_t GetTileWord(int x, int y) const { return _tiles[(size_t)(y >> 3) * TILES_PER_ROW + (x >> 3)]; }
+	static int GetTileBit(int x, int y) { return ((y & 7) << 3) | (x & 7); }
+};
@@ -0,0 +1,107 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+
+// long enough for a few seconds of trace at 60 fps, the overlay only looks at the newest samples
+const int PROFILER_RING_SIZE = 4096;
+const int PROFILER_ROLLING_SAMPLES = 128;
+
+// relaxed atomics so a reader racing the writer gets a stale sample, never a torn one
+struct StageSample
+{
+	std::atomic<long long> StartNs;
+	std::atomic<long long> DurationNs;
+};
+
+struct alignas(64) StageRing
+{
+	std::atomic<unsigned int> WriteIndex;
+	StageSample Samples[PROFILER_RING_SIZE];
+};
+
+static StageRing _rings[FRAME_STAGE_COUNT];
+static const std::chrono::steady_clock::time_point _profilerEpoch = std::chrono::steady_clock::now();
+
+long long GetProfilerTimeNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _profilerEpoch).count();
+}
+
+void RecordStageSample(FrameStage stage, long long startNs, long long durationNs)
+{
+	StageRing& ring = _rings[(int)stage];
+	// claimed before it is written, a reader may see the slot's older sample but writers never share one
+	unsigned int index = ring.WriteIndex.fetch_add(1, std::memory_order_acq_rel);
+
+	StageSample& sample = ring.Samples[index % PROFILER_RING_SIZE];
+	sample.StartNs.store(startNs, std::memory_order_relaxed);
+	sample.DurationNs.store(durationNs, std::memory_order_relaxed);
+}
+
+StageStats GetStageStats(FrameStage stage)
+{
+	const StageRing& ring = _rings[(int)stage];
+	unsigned int writeIndex = ring.WriteIndex.load(std::memory_order_acquire);
+	int sampleCount = (int)std::min<unsigned int>(writeIndex, PROFILER_ROLLING_SAMPLES);
+	if (sampleCount == 0)
+		return { 0.0f, 0.0f, 0.0f, 0 };
+
+	long long durations[PROFILER_ROLLING_SAMPLES];
+	long long total = 0;
+	for (int i = 0; i < sampleCount; i++)
+	{
+		durations[i] = ring.Samples[(writeIndex - 1 - i) % PROFILER_RING_SIZE].DurationNs.load(std::memory_order_relaxed);
+		total += durations[i];
+	}
+
+	int p99Index = (sampleCount * 99) / 100;
+	std::nth_element(durations, durations + p99Index, durations + sampleCount);
+	long long p99 = durations[p99Index];
+	long long minimum = *std::min_element(durations, durations + sampleCount);
+
+	return { minimum / 1e6f, (float)(total / 1e6 / sampleCount), p99 / 1e6f, sampleCount };
+}
+
+const char* GetStageName(FrameStage stage)
+{
+	switch (stage)
+	{
+	case FrameStage::Input:		return "input";
+	case FrameStage::Raycast:	return "raycast";
+	case FrameStage::Overlays:	return "overlays";
+	case FrameStage::Present:	return "present";
+	default:					return "?";
+	}
+}
+
+bool WriteChromeTrace(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	bool first = true;
+
+	for (int stage = 0; stage < FRAME_STAGE_COUNT; stage++)
+	{
+		const StageRing& ring = _rings[stage];
+		unsigned int writeIndex = ring.WriteIndex.load(std::memory_order_acquire);
+		unsigned int sampleCount = std::min<unsigned int>(writeIndex, PROFILER_RING_SIZE);
+
+		// one track per stage, timestamps in microseconds
+		for (unsigned int i = writeIndex - sampleCount; i != writeIndex; i++)
+		{
+			const StageSample& sample = ring.Samples[i % PROFILER_RING_SIZE];
+			fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				first ? "" : ",\n", GetStageName((FrameStage)stage), stage + 1,
+				sample.StartNs.load(std::memory_order_relaxed) / 1000.0, sample.DurationNs.load(std::memory_order_relaxed) / 1000.0);
+			first = false;
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	return fclose(file) == 0;
+}
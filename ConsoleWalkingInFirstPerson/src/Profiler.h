@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+
+// 0 compiles every PROFILE_STAGE and the profiler overlay out
+#ifndef PROFILER_ENABLED
+	#define PROFILER_ENABLED 1
+#endif
+
+enum class FrameStage { Input = 0, Raycast = 1, Overlays = 2, Present = 3 };
+const int FRAME_STAGE_COUNT = 4;
+
+// over the last PROFILER_ROLLING_SAMPLES frames
+struct StageStats
+{
+	float MinMs;
+	float AvgMs;
+	float P99Ms;
+	int SampleCount;
+};
+
+// samples go into a lock-free ring per stage, any number of threads may record at once, e.g. server sessions rendering in parallel
+void RecordStageSample(FrameStage stage, long long startNs, long long durationNs);
+StageStats GetStageStats(FrameStage stage);
+const char* GetStageName(FrameStage stage);
+long long GetProfilerTimeNs();
+
+// chrome://tracing / Perfetto json of every sample still in the rings
+bool WriteChromeTrace(const char* path);
+
+#if PROFILER_ENABLED
+
+class ScopedStageTimer
+{
+public:
+	explicit ScopedStageTimer(FrameStage stage) : _stage(stage), _startNs(GetProfilerTimeNs()) {}
+	~ScopedStageTimer() { RecordStageSample(_stage, _startNs, GetProfilerTimeNs() - _startNs); }
+
+private:
+	FrameStage _stage;
+	long long _startNs;
+};
+
+#define PROFILE_STAGE_CONCAT_INNER(a, b) a##b
+#define PROFILE_STAGE_CONCAT(a, b) PROFILE_STAGE_CONCAT_INNER(a, b)
+#define PROFILE_STAGE(stage) ScopedStageTimer PROFILE_STAGE_CONCAT(_stageTimer, __LINE__)(stage)
+
+#else
+
+#define PROFILE_STAGE(stage) ((void)0)
+
+#endif
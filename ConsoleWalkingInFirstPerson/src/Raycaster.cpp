@@ -0,0 +1,365 @@
+#include "Raycaster.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define RAYCASTER_HAS_X86_SIMD
+	#include <immintrin.h>
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+		#define RAYCASTER_TARGET_AVX2
+	#else
+		#define RAYCASTER_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+// one walk for both CastRay overloads, with SKIP_EMPTY_SPACE it reads the field before every step
+template <bool SKIP_EMPTY_SPACE>
+static RayHit WalkRay(const OccupancyView& map, const DistanceFieldView& field,
+	const Vector2f& origin, const Vector2f& direction, float maxDistance)
+{
+	const float INF = std::numeric_limits<float>::infinity();
+
+	Vector2n cell { (int)std::floor(origin.X), (int)std::floor(origin.Y) };
+	if (map.Contains(cell.X, cell.Y) && map.IsWall(cell.X, cell.Y))
+		return { 0.0f, cell, WallFace::None, true };
+
+	// distance along the ray between two vertical / horizontal cell borders
+	Vector2f deltaDistance
+	{
+		direction.X != 0.0f ? std::fabs(1.0f / direction.X) : INF,
+		direction.Y != 0.0f ? std::fabs(1.0f / direction.Y) : INF
+	};
+
+	Vector2n step { direction.X < 0.0f ? -1 : 1, direction.Y < 0.0f ? -1 : 1 };
+
+	// distance along the ray to the first vertical / horizontal cell border
+	Vector2f sideDistance
+	{
+		direction.X < 0.0f ? (origin.X - cell.X) * deltaDistance.X : (cell.X + 1.0f - origin.X) * deltaDistance.X,
+		direction.Y < 0.0f ? (origin.Y - cell.Y) * deltaDistance.Y : (cell.Y + 1.0f - origin.Y) * deltaDistance.Y
+	};
+
+	while (true)
+	{
+		float distance;
+		WallFace face;
+
+		if (SKIP_EMPTY_SPACE && map.Contains(cell.X, cell.Y))
+		{
+			// the square of cells within reach around this one is empty, only the step that leaves it needs a lookup
+			int reach = field.GetClearance(cell.X, cell.Y) - 1;
+			if (reach > 0)
+			{
+				float exitDistance = std::min(sideDistance.X + reach * deltaDistance.X, sideDistance.Y + reach * deltaDistance.Y);
+				if (exitDistance >= maxDistance)
+					return { maxDistance, cell, WallFace::None, false };
+
+				// borders crossed before the exit, capped so rounding can not carry the cell out of the square
+				if (sideDistance.X < exitDistance)
+				{
+					int stepsX = std::min(reach, (int)((exitDistance - sideDistance.X) * std::fabs(direction.X)) + 1);
+					sideDistance.X += stepsX * deltaDistance.X;
+					cell.X += stepsX * step.X;
+				}
+				if (sideDistance.Y < exitDistance)
+				{
+					int stepsY = std::min(reach, (int)((exitDistance - sideDistance.Y) * std::fabs(direction.Y)) + 1);
+					sideDistance.Y += stepsY * deltaDistance.Y;
+					cell.Y += stepsY * step.Y;
+				}
+			}
+		}
+
+		if (sideDistance.X < sideDistance.Y)
+		{
+			distance = sideDistance.X;
+			sideDistance.X += deltaDistance.X;
+			cell.X += step.X;
+			face = step.X > 0 ? WallFace::West : WallFace::East;
+		}
+		else
+		{
+			distance = sideDistance.Y;
+			sideDistance.Y += deltaDistance.Y;
+			cell.Y += step.Y;
+			face = step.Y > 0 ? WallFace::North : WallFace::South;
+		}
+
+		if (distance >= maxDistance || !map.Contains(cell.X, cell.Y))
+			return { maxDistance, cell, WallFace::None, false };
+
+		if (map.IsWall(cell.X, cell.Y))
+			return { distance, cell, face, true };
+	}
+}
+
+RayHit CastRay(const OccupancyView& map, const Vector2f& origin, const Vector2f& direction, float maxDistance)
+{
+	return WalkRay<false>(map, {}, origin, direction, maxDistance);
+}
+
+RayHit CastRay(const OccupancyView& map, const DistanceFieldView& field, const Vector2f& origin, const Vector2f& direction, float maxDistance)
+{
+	return WalkRay<true>(map, field, origin, direction, maxDistance);
+}
+
+
+static void CastRaysScalar(const OccupancyView& map, const Vector2f& origin,
+	const float* directionsX, const float* directionsY, int count, float maxDistance, float* distances)
+{
+	for (int i = 0; i < count; i++)
+		distances[i] = CastRay(map, origin, { directionsX[i], directionsY[i] }, maxDistance).Distance;
+}
+
+#ifdef RAYCASTER_HAS_X86_SIMD
+
+// the lane kernels mirror CastRay operation by operation (no rcp, no fma) so results match bit for bit
+// wall lookups are bit tests inside 8x8 tiles, so they are done per lane instead of gathered
+
+static void CastLanesSse2(const OccupancyView& map, const Vector2f& origin, const Vector2n& originCell,
+	const float* directionsX, const float* directionsY, float maxDistance, float* distances)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	const __m128 maxDist = _mm_set1_ps(maxDistance);
+	const __m128i lastColumn = _mm_set1_epi32(map.Width - 1);
+	const __m128i lastRow = _mm_set1_epi32(map.Height - 1);
+
+	const __m128 dirX = _mm_loadu_ps(directionsX);
+	const __m128 dirY = _mm_loadu_ps(directionsY);
+	const __m128 originX = _mm_set1_ps(origin.X);
+	const __m128 originY = _mm_set1_ps(origin.Y);
+
+	__m128i cellX = _mm_set1_epi32(originCell.X);
+	__m128i cellY = _mm_set1_epi32(originCell.Y);
+	const __m128 cellXf = _mm_cvtepi32_ps(cellX);
+	const __m128 cellYf = _mm_cvtepi32_ps(cellY);
+
+	const __m128 deltaX = _mm_and_ps(_mm_div_ps(one, dirX), absMask);
+	const __m128 deltaY = _mm_and_ps(_mm_div_ps(one, dirY), absMask);
+
+	const __m128 negativeX = _mm_cmplt_ps(dirX, zero);
+	const __m128 negativeY = _mm_cmplt_ps(dirY, zero);
+	const __m128i stepX = _mm_or_si128(_mm_castps_si128(negativeX), _mm_set1_epi32(1));
+	const __m128i stepY = _mm_or_si128(_mm_castps_si128(negativeY), _mm_set1_epi32(1));
+
+	__m128 sideX = _mm_or_ps(
+		_mm_and_ps(negativeX, _mm_mul_ps(_mm_sub_ps(originX, cellXf), deltaX)),
+		_mm_andnot_ps(negativeX, _mm_mul_ps(_mm_sub_ps(_mm_add_ps(cellXf, one), originX), deltaX)));
+	__m128 sideY = _mm_or_ps(
+		_mm_and_ps(negativeY, _mm_mul_ps(_mm_sub_ps(originY, cellYf), deltaY)),
+		_mm_andnot_ps(negativeY, _mm_mul_ps(_mm_sub_ps(_mm_add_ps(cellYf, one), originY), deltaY)));
+
+	for (int lane = 0; lane < 4; lane++)
+		distances[lane] = maxDistance;
+
+	int activeLanes = 0xF;
+	alignas(16) int laneCellX[4], laneCellY[4];
+	alignas(16) float laneDistance[4];
+
+	while (activeLanes)
+	{
+		const __m128 stepInX = _mm_cmplt_ps(sideX, sideY);
+		const __m128i stepInXi = _mm_castps_si128(stepInX);
+		const __m128 distance = _mm_or_ps(_mm_and_ps(stepInX, sideX), _mm_andnot_ps(stepInX, sideY));
+
+		sideX = _mm_or_ps(_mm_and_ps(stepInX, _mm_add_ps(sideX, deltaX)), _mm_andnot_ps(stepInX, sideX));
+		sideY = _mm_or_ps(_mm_andnot_ps(stepInX, _mm_add_ps(sideY, deltaY)), _mm_and_ps(stepInX, sideY));
+		cellX = _mm_add_epi32(cellX, _mm_and_si128(stepInXi, stepX));
+		cellY = _mm_add_epi32(cellY, _mm_andnot_si128(stepInXi, stepY));
+
+		__m128i outOfMap = _mm_or_si128(
+			_mm_or_si128(_mm_cmpgt_epi32(cellX, lastColumn), _mm_cmplt_epi32(cellX, _mm_setzero_si128())),
+			_mm_or_si128(_mm_cmpgt_epi32(cellY, lastRow), _mm_cmplt_epi32(cellY, _mm_setzero_si128())));
+		__m128 missed = _mm_or_ps(_mm_cmpge_ps(distance, maxDist), _mm_castsi128_ps(outOfMap));
+		activeLanes &= ~_mm_movemask_ps(missed);
+
+		_mm_store_si128((__m128i*)laneCellX, cellX);
+		_mm_store_si128((__m128i*)laneCellY, cellY);
+		_mm_store_ps(laneDistance, distance);
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if ((activeLanes & (1 << lane)) && map.IsWall(laneCellX[lane], laneCellY[lane]))
+			{
+				distances[lane] = laneDistance[lane];
+				activeLanes &= ~(1 << lane);
+			}
+		}
+	}
+}
+
+RAYCASTER_TARGET_AVX2
+static void CastLanesAvx2(const OccupancyView& map, const Vector2f& origin, const Vector2n& originCell,
+	const float* directionsX, const float* directionsY, float maxDistance, float* distances)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	const __m256 maxDist = _mm256_set1_ps(maxDistance);
+	const __m256i lastColumn = _mm256_set1_epi32(map.Width - 1);
+	const __m256i lastRow = _mm256_set1_epi32(map.Height - 1);
+
+	const __m256 dirX = _mm256_loadu_ps(directionsX);
+	const __m256 dirY = _mm256_loadu_ps(directionsY);
+	const __m256 originX = _mm256_set1_ps(origin.X);
+	const __m256 originY = _mm256_set1_ps(origin.Y);
+
+	__m256i cellX = _mm256_set1_epi32(originCell.X);
+	__m256i cellY = _mm256_set1_epi32(originCell.Y);
+	const __m256 cellXf = _mm256_cvtepi32_ps(cellX);
+	const __m256 cellYf = _mm256_cvtepi32_ps(cellY);
+
+	const __m256 deltaX = _mm256_and_ps(_mm256_div_ps(one, dirX), absMask);
+	const __m256 deltaY = _mm256_and_ps(_mm256_div_ps(one, dirY), absMask);
+
+	const __m256 negativeX = _mm256_cmp_ps(dirX, zero, _CMP_LT_OQ);
+	const __m256 negativeY = _mm256_cmp_ps(dirY, zero, _CMP_LT_OQ);
+	const __m256i stepX = _mm256_or_si256(_mm256_castps_si256(negativeX), _mm256_set1_epi32(1));
+	const __m256i stepY = _mm256_or_si256(_mm256_castps_si256(negativeY), _mm256_set1_epi32(1));
+
+	__m256 sideX = _mm256_blendv_ps(
+		_mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(cellXf, one), originX), deltaX),
+		_mm256_mul_ps(_mm256_sub_ps(originX, cellXf), deltaX), negativeX);
+	__m256 sideY = _mm256_blendv_ps(
+		_mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(cellYf, one), originY), deltaY),
+		_mm256_mul_ps(_mm256_sub_ps(originY, cellYf), deltaY), negativeY);
+
+	for (int lane = 0; lane < 8; lane++)
+		distances[lane] = maxDistance;
+
+	int activeLanes = 0xFF;
+	alignas(32) int laneCellX[8], laneCellY[8];
+	alignas(32) float laneDistance[8];
+
+	while (activeLanes)
+	{
+		const __m256 stepInX = _mm256_cmp_ps(sideX, sideY, _CMP_LT_OQ);
+		const __m256i stepInXi = _mm256_castps_si256(stepInX);
+		const __m256 distance = _mm256_blendv_ps(sideY, sideX, stepInX);
+
+		sideX = _mm256_blendv_ps(sideX, _mm256_add_ps(sideX, deltaX), stepInX);
+		sideY = _mm256_blendv_ps(_mm256_add_ps(sideY, deltaY), sideY, stepInX);
+		cellX = _mm256_add_epi32(cellX, _mm256_and_si256(stepInXi, stepX));
+		cellY = _mm256_add_epi32(cellY, _mm256_andnot_si256(stepInXi, stepY));
+
+		__m256i outOfMap = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpgt_epi32(cellX, lastColumn), _mm256_cmpgt_epi32(_mm256_setzero_si256(), cellX)),
+			_mm256_or_si256(_mm256_cmpgt_epi32(cellY, lastRow), _mm256_cmpgt_epi32(_mm256_setzero_si256(), cellY)));
+		__m256 missed = _mm256_or_ps(_mm256_cmp_ps(distance, maxDist, _CMP_GE_OQ), _mm256_castsi256_ps(outOfMap));
+		activeLanes &= ~_mm256_movemask_ps(missed);
+
+		_mm256_store_si256((__m256i*)laneCellX, cellX);
+		_mm256_store_si256((__m256i*)laneCellY, cellY);
+		_mm256_store_ps(laneDistance, distance);
+
+		for (int lane = 0; lane < 8; lane++)
+		{
+			if ((activeLanes & (1 << lane)) && map.IsWall(laneCellX[lane], laneCellY[lane]))
+			{
+				distances[lane] = laneDistance[lane];
+				activeLanes &= ~(1 << lane);
+			}
+		}
+	}
+}
+
+static bool CpuSupportsAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 1);
+	bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+	__cpuidex(info, 7, 0);
+	return osSavesYmm && (info[1] & (1 << 5));
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+static void CastRaysLanes(const OccupancyView& map, const Vector2f& origin,
+	const float* directionsX, const float* directionsY, int count, float maxDistance, float* distances, RaycastKernel kernel)
+{
+	Vector2n originCell { (int)std::floor(origin.X), (int)std::floor(origin.Y) };
+	if (map.Contains(originCell.X, originCell.Y) && map.IsWall(originCell.X, originCell.Y))
+	{
+		for (int i = 0; i < count; i++)
+			distances[i] = 0.0f;
+		return;
+	}
+
+	int i = 0;
+#ifdef RAYCASTER_HAS_X86_SIMD
+	if (kernel == RaycastKernel::Avx2)
+		for (; i + 8 <= count; i += 8)
+			CastLanesAvx2(map, origin, originCell, directionsX + i, directionsY + i, maxDistance, distances + i);
+	for (; i + 4 <= count; i += 4)
+		CastLanesSse2(map, origin, originCell, directionsX + i, directionsY + i, maxDistance, distances + i);
+#endif
+	CastRaysScalar(map, origin, directionsX + i, directionsY + i, count - i, maxDistance, distances + i);
+}
+
+void CastRays(const OccupancyView& map, const Vector2f& origin,
+	const float* directionsX, const float* directionsY, int count, float maxDistance, float* distances, RaycastKernel kernel)
+{
+	if (kernel == RaycastKernel::Scalar || !IsRaycastKernelSupported(kernel))
+		CastRaysScalar(map, origin, directionsX, directionsY, count, maxDistance, distances);
+	else
+		CastRaysLanes(map, origin, directionsX, directionsY, count, maxDistance, distances, kernel);
+}
+
+void CastRays(const OccupancyView& map, const Vector2f& origin,
+	const float* directionsX, const float* directionsY, int count, float maxDistance, float* distances)
+{
+	static const RaycastKernel bestKernel = GetBestRaycastKernel();
+	CastRays(map, origin, directionsX, directionsY, count, maxDistance, distances, bestKernel);
+}
+
+void CastRays(const OccupancyView& map, const DistanceFieldView& field, const Vector2f& origin,
+	const float* directionsX, const float* directionsY, int count, float maxDistance, float* distances)
+{
+	// skipping is per ray and data dependent, so there are no lane kernels for it
+	for (int i = 0; i < count; i++)
+		distances[i] = CastRay(map, field, origin, { directionsX[i], directionsY[i] }, maxDistance).Distance;
+}
+
+bool IsRaycastKernelSupported(RaycastKernel kernel)
+{
+	switch (kernel)
+	{
+#ifdef RAYCASTER_HAS_X86_SIMD
+	case RaycastKernel::Sse2:	return true;
+	case RaycastKernel::Avx2:	return CpuSupportsAvx2();
+#else
+	case RaycastKernel::Sse2:	return false;
+	case RaycastKernel::Avx2:	return false;
+#endif
+	default:					return true;
+	}
+}
+
+RaycastKernel GetBestRaycastKernel()
+{
+	if (IsRaycastKernelSupported(RaycastKernel::Avx2))
+		return RaycastKernel::Avx2;
+	else if (IsRaycastKernelSupported(RaycastKernel::Sse2))
+		return RaycastKernel::Sse2;
+	else
+		return RaycastKernel::Scalar;
+}
+
+const char* GetRaycastKernelName(RaycastKernel kernel)
+{
+	switch (kernel)
+	{
+	case RaycastKernel::Sse2:	return "sse2";
+	case RaycastKernel::Avx2:	return "avx2";
+	default:					return "scalar";
+	}
+}
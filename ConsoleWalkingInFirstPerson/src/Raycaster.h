@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Vector2.h"
+#include "OccupancyGrid.h"
+#include "DistanceField.h"
+
+// side of the hit cell the ray entered through
+enum class WallFace { None, West, East, North, South };
+
+struct RayHit
+{
+	float Distance;
+	Vector2n Cell;
+	WallFace Face;
+	bool Hit;
+};
+
+enum class RaycastKernel { Scalar, Sse2, Avx2 };
+
+// walks the map cell by cell (DDA), every cell on the ray is visited exactly once
+RayHit CastRay(const OccupancyView& map, const Vector2f& origin, const Vector2f& direction, float maxDistance);
+// same walk, but jumps across the empty square the field promises around the current cell,
+// worth it on open maps with a long maxDistance, distances may differ from CastRay in the last bits
+RayHit CastRay(const OccupancyView& map, const DistanceFieldView& field, const Vector2f& origin, const Vector2f& direction, float maxDistance);
+
+// casts a whole frame of rays sharing one origin, directions and distances are structure of arrays
+// a ray that hits nothing gets maxDistance, results are bit-identical between kernels
+void CastRays(const OccupancyView& map, const Vector2f& origin,
+	const float* directionsX, const float* directionsY, int count, float maxDistance, float* distances);
+void CastRays(const OccupancyView& map, const Vector2f& origin,
+	const float* directionsX, const float* directionsY, int count, float maxDistance, float* distances, RaycastKernel kernel);
+
+void CastRays(const OccupancyView& map, const DistanceFieldView& field, const Vector2f& origin,
+	const float* directionsX, const float* directionsY, int count, float maxDistance, float* distances);
+
+// widest kernel supported by this build and cpu, detected once
+RaycastKernel GetBestRaycastKernel();
+bool IsRaycastKernelSupported(RaycastKernel kernel);
+const char* GetRaycastKernelName(RaycastKernel kernel);
@@ -0,0 +1,74 @@
+#include "RenderTables.h"
+
+#include <algorithm>
+#include <cmath>
+
+static int GetScreenCeilingSizeFromDistanceToWall(float distanceToWall, int rows)
+{
+	float screenHalf = rows / 2.0f;
+	float ceilingSize = screenHalf - screenHalf / distanceToWall;
+	return static_cast<int>(std::clamp<float>(ceilingSize, 0.0f, screenHalf));
+}
+
+static wchar_t GetWallShadeFromDistance(float distance, float maxDistance)
+{
+	if (distance <= maxDistance / 4.0f)			return 0x2588;	// very close	
+	else if (distance < maxDistance / 3.0f)		return 0x2593;
+	else if (distance < maxDistance / 2.0f)		return 0x2592;
+	else if (distance < maxDistance)			return 0x2591;
+	else										return ' ';		// very far away
+}
+
+static wchar_t GetFloorShadeFromScreenY(int y, int rows)
+{
+	float screenHalf = rows / 2.0f;
+	float highness = 1.0f - ((y - screenHalf) / screenHalf);
+	if (highness < 0.25)		return '#';
+	else if (highness < 0.5)	return 'x';
+	else if (highness < 0.75)	return '.';
+	else if (highness < 0.9)	return '-';
+	else						return ' ';
+}
+
+
+RenderTables::RenderTables()
+	:	COLUMNS(0), ROWS(0), FOV(0.0f), MAX_DISTANCE(0.0f),
+		_cameraDirX(), _cameraDirY(), _ceilingSizes(), _wallShades(), _floorColumn()
+{}
+
+RenderTables::~RenderTables() {}
+
+bool RenderTables::Update(const int columns, const int rows, const float fov, const float maxDistance)
+{
+	if (columns == COLUMNS && rows == ROWS && fov == FOV && maxDistance == MAX_DISTANCE)
+		return false;
+
+	COLUMNS = columns; ROWS = rows; FOV = fov; MAX_DISTANCE = maxDistance;
+
+	_cameraDirX.resize(columns);
+	_cameraDirY.resize(columns);
+	for (int x = 0; x < columns; x++)
+	{
+		float angleFromView = -fov / 2.0f + ((float)x / (float)columns) * fov;
+		_cameraDirX[x] = cosf(angleFromView);
+		_cameraDirY[x] = sinf(angleFromView);
+	}
+
+	// the last entry is maxDistance itself, what a ray that hit nothing reports
+	int distanceSteps = (int)std::ceil(maxDistance * DISTANCE_STEPS_PER_UNIT) + 1;
+	_ceilingSizes.resize(distanceSteps);
+	_wallShades.resize(distanceSteps);
+	for (int i = 0; i < distanceSteps; i++)
+	{
+		// middle of the step, except for the last one which stands for everything past maxDistance
+		float distance = i == distanceSteps - 1 ? maxDistance : (i + 0.5f) / DISTANCE_STEPS_PER_UNIT;
+		_ceilingSizes[i] = (unsigned short)GetScreenCeilingSizeFromDistanceToWall(distance, rows);
+		_wallShades[i] = GetWallShadeFromDistance(distance, maxDistance);
+	}
+
+	_floorColumn.resize(rows);
+	for (int y = 0; y < rows; y++)
+		_floorColumn[y] = GetFloorShadeFromScreenY(y, rows);
+
+	return true;
+}
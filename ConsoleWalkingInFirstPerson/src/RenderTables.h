@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+// everything the column renderer can know before the player moves,
+// rebuilt only when the resolution, fov or rendering distance changes
+class RenderTables
+{
+public:
+	RenderTables();
+	~RenderTables();
+
+	// cheap when nothing changed, safe to call every frame, returns true when the tables were rebuilt
+	bool Update(const int columns, const int rows, const float fov, const float maxDistance);
+
+	int GetColumns() const { return COLUMNS; }
+	int GetRows() const { return ROWS; }
+
+	// ray direction of column x relative to the view direction (view direction is +X)
+	float GetCameraDirX(int x) const { return _cameraDirX[x]; }
+	float GetCameraDirY(int x) const { return _cameraDirY[x]; }
+	// cos of the column's angle to the view direction, turns ray length into depth
+	float GetDepthFactor(int x) const { return _cameraDirX[x]; }
+	// columns are evenly spaced in angle, turning by this much moves the image by one column
+	float GetColumnAngleStep() const { return FOV / COLUMNS; }
+
+	int GetCeilingSize(float distance) const { return _ceilingSizes[GetDistanceIndex(distance)]; }
+	wchar_t GetWallShade(float distance) const { return _wallShades[GetDistanceIndex(distance)]; }
+	// shade for every screen row, only rows below the wall are read
+	const wchar_t* GetFloorColumn() const { return _floorColumn.data(); }
+
+private:
+	// distance is quantized to 1/DISTANCE_STEPS_PER_UNIT of a map cell
+	static const int DISTANCE_STEPS_PER_UNIT = 128;
+
+	int COLUMNS, ROWS;
+	float FOV, MAX_DISTANCE;
+
+	std::vector<float> _cameraDirX;
+	std::vector<float> _cameraDirY;
+	std::vector<unsigned short> _ceilingSizes;
+	std::vector<wchar_t> _wallShades;
+	std::vector<wchar_t> _floorColumn;
+
+	int GetDistanceIndex(float distance) const
+	{
+		int index = (int)(distance * DISTANCE_STEPS_PER_UNIT);
+		int lastIndex = (int)_wallShades.size() - 1;
+		return index < 0 ? 0 : (index > lastIndex ? lastIndex : index);
+	}
+};
@@ -0,0 +1,46 @@
+#include "ResolutionScaler.h"
+
+#include <algorithm>
+
+// over this share of the budget rays are dropped, under the other share they are added back,
+// the gap between them keeps the ray count from flipping every window
+const float SCALE_DOWN_LOAD = 0.95f;
+const float SCALE_UP_LOAD = 0.7f;
+const float SCALE_UP_STEP = 1.1f;
+
+ResolutionScaler::ResolutionScaler(const float budgetMs, const float minFraction)
+	:	BUDGET_MS(budgetMs), MIN_FRACTION(minFraction), _rays(0), _windowMs(0.0f), _windowFrames(0)
+{}
+
+ResolutionScaler::~ResolutionScaler() {}
+
+int ResolutionScaler::Update(const float frameMs, const int columns)
+{
+	if (BUDGET_MS <= 0.0f)
+		return _rays = columns;
+
+	const int minRays = std::max(2, (int)(columns * MIN_FRACTION));
+	if (_rays <= 0 || _rays > columns)
+		_rays = columns;
+
+	_windowMs += frameMs;
+	if (++_windowFrames < WINDOW_FRAMES)
+		return _rays;
+
+	float load = _windowMs / _windowFrames / BUDGET_MS;
+	_windowMs = 0.0f;
+	_windowFrames = 0;
+
+	// most of a frame is per column work, so the ray count is cut in proportion to the overrun
+	if (load > SCALE_DOWN_LOAD)
+		_rays = std::max(minRays, (int)(_rays * SCALE_DOWN_LOAD / load));
+	else if (load < SCALE_UP_LOAD)
+		_rays = std::min(columns, std::max(_rays + 1, (int)(_rays * SCALE_UP_STEP)));
+
+	return _rays;
+}
+
+int ResolutionScaler::GetRays() const
+{
+	return _rays;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+// picks how many rays a frame casts so frames stay inside a time budget,
+// drops fast when frames run over and climbs back slowly once there is room
+class ResolutionScaler
+{
+public:
+	// budgetMs 0 - always one ray per column, minFraction is the lowest share of columns it goes down to
+	ResolutionScaler(const float budgetMs, const float minFraction);
+	~ResolutionScaler();
+
+	// feed how long the last frame took to render and present, returns the ray count for the next frame
+	int Update(const float frameMs, const int columns);
+	int GetRays() const;
+
+private:
+	// frames averaged before every decision, one slow frame is not a trend
+	static const int WINDOW_FRAMES = 8;
+
+	float BUDGET_MS;
+	float MIN_FRACTION;
+
+	int _rays;
+	float _windowMs;
+	int _windowFrames;
+};
\ No newline at end of file
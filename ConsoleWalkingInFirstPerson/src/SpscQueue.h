@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// bounded lock-free ring for exactly one producer thread and one consumer thread
+// CAPACITY has to be a power of two, a push into a full queue fails instead of waiting
+template <typename T, size_t CAPACITY>
+class SpscQueue
+{
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "SpscQueue capacity has to be a power of two");
+
+public:
+	SpscQueue() : _head(0), _tail(0) {}
+
+	// producer only
+	bool Push(const T& item)
+	{
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		if (tail - _head.load(std::memory_order_acquire) == CAPACITY)
+			return false;
+
+		_items[tail & (CAPACITY - 1)] = item;
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer only
+	bool Pop(T& item)
+	{
+		size_t head = _head.load(std::memory_order_relaxed);
+		if (head == _tail.load(std::memory_order_acquire))
+			return false;
+
+		item = _items[head & (CAPACITY - 1)];
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool IsEmpty() const
+	{
+		return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+	}
+
+private:
+	T _items[CAPACITY];
+	// on separate cache lines, each is written by one side only
+	alignas(64) std::atomic<size_t> _head;
+	alignas(64) std::atomic<size_t> _tail;
+};
\ No newline at end of file
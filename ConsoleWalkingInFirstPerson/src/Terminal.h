@@ -0,0 +1,15 @@
+#pragma once
+
+#include <memory>
+
+// where finished frames go, screen is width * height cells row after row
+class Terminal
+{
+public:
+	virtual ~Terminal() {}
+
+	virtual void Present(const wchar_t* screen) = 0;
+};
+
+// console of the platform the game was built for
+std::unique_ptr<Terminal> CreatePlatformTerminal(const int width, const int height);
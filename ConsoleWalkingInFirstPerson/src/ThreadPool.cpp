@@ -0,0 +1,140 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadCount)
+	:	THREAD_COUNT(threadCount > 0 ? threadCount : std::max(1, (int)std::thread::hardware_concurrency())),
+		_workers(), _queues(),
+		_task(nullptr), _generation(0), _busyWorkers(0), _stopping(false), _remainingTasks(0)
+{
+	_queues.reset(new TaskQueue[THREAD_COUNT]);
+
+	// queue 0 belongs to the thread calling ParallelFor
+	for (int i = 1; i < THREAD_COUNT; i++)
+		_workers.emplace_back(&ThreadPool::_WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wakeUp.notify_all();
+
+	for (auto& worker : _workers)
+		worker.join();
+}
+
+int ThreadPool::GetThreadCount() const { return THREAD_COUNT; }
+
+void ThreadPool::ParallelFor(int taskCount, const std::function<void(int)>& task)
+{
+	if (taskCount <= 0)
+		return;
+
+	if (THREAD_COUNT == 1)
+	{
+		for (int i = 0; i < taskCount; i++)
+			task(i);
+		return;
+	}
+
+	// contiguous blocks keep neighbouring tasks on one thread unless someone steals them
+	for (int q = 0; q < THREAD_COUNT; q++)
+	{
+		std::lock_guard<std::mutex> lock(_queues[q].Mutex);
+		for (int i = q * taskCount / THREAD_COUNT; i < (q + 1) * taskCount / THREAD_COUNT; i++)
+			_queues[q].Tasks.push_back(i);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = &task;
+		_remainingTasks = taskCount;
+		_generation++;
+	}
+	_wakeUp.notify_all();
+
+	_RunTasks(0, task);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_allDone.wait(lock, [this] { return _remainingTasks == 0 && _busyWorkers == 0; });
+	_task = nullptr;
+}
+
+void ThreadPool::_WorkerLoop(int queueIndex)
+{
+	unsigned int seenGeneration = 0;
+
+	while (true)
+	{
+		const std::function<void(int)>* task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeUp.wait(lock, [&] { return _stopping || _generation != seenGeneration; });
+			if (_stopping)
+				return;
+
+			seenGeneration = _generation;
+			// woke up after the batch was already finished by others
+			if (_remainingTasks == 0)
+				continue;
+
+			task = _task;
+			_busyWorkers++;
+		}
+
+		_RunTasks(queueIndex, *task);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_busyWorkers--;
+		}
+		_allDone.notify_all();
+	}
+}
+
+void ThreadPool::_RunTasks(int queueIndex, const std::function<void(int)>& task)
+{
+	int taskIndex;
+	while (_PopTask(queueIndex, taskIndex) || _StealTask(queueIndex, taskIndex))
+	{
+		task(taskIndex);
+
+		if (--_remainingTasks == 0)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_allDone.notify_all();
+		}
+	}
+}
+
+bool ThreadPool::_PopTask(int queueIndex, int& task)
+{
+	TaskQueue& queue = _queues[queueIndex];
+	std::lock_guard<std::mutex> lock(queue.Mutex);
+	if (queue.Tasks.empty())
+		return false;
+
+	task = queue.Tasks.back();
+	queue.Tasks.pop_back();
+	return true;
+}
+
+bool ThreadPool::_StealTask(int thiefIndex, int& task)
+{
+	for (int i = 1; i < THREAD_COUNT; i++)
+	{
+		TaskQueue& victim = _queues[(thiefIndex + i) % THREAD_COUNT];
+		std::lock_guard<std::mutex> lock(victim.Mutex);
+		if (victim.Tasks.empty())
+			continue;
+
+		task = victim.Tasks.front();
+		victim.Tasks.pop_front();
+		return true;
+	}
+
+	return false;
+}
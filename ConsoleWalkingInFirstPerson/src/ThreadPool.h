@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+// persistent workers, every ParallelFor splits its tasks into one queue per thread
+// and threads that run dry steal from the front of other queues
+class ThreadPool
+{
+public:
+	// 0 - one thread per hardware core, the calling thread counts as one of them
+	explicit ThreadPool(int threadCount);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int GetThreadCount() const;
+
+	// runs task(i) for every i in [0, taskCount) and returns when all of them are done
+	// a pool of one thread runs the tasks right on the caller and touches none of its own state, any number of threads may share it
+	void ParallelFor(int taskCount, const std::function<void(int)>& task);
+
+private:
+	struct alignas(64) TaskQueue
+	{
+		std::mutex Mutex;
+		std::deque<int> Tasks;
+	};
+
+	int THREAD_COUNT;
+	std::vector<std::thread> _workers;
+	std::unique_ptr<TaskQueue[]> _queues;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeUp;
+	std::condition_variable _allDone;
+	const std::function<void(int)>* _task;
+	unsigned int _generation;
+	int _busyWorkers;
+	bool _stopping;
+	alignas(64) std::atomic<int> _remainingTasks;
+
+	void _WorkerLoop(int queueIndex);
+	void _RunTasks(int queueIndex, const std::function<void(int)>& task);
+	bool _PopTask(int queueIndex, int& task);
+	bool _StealTask(int thiefIndex, int& task);
+};
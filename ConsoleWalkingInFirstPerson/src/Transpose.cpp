@@ -0,0 +1,107 @@
+#include "Transpose.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define TRANSPOSE_HAS_X86_SIMD
+	#include <emmintrin.h>
+#endif
+
+#ifdef TRANSPOSE_HAS_X86_SIMD
+// cells in one SSE2 register, 8 on Windows where wchar_t is 16 bits, 4 elsewhere
+const int TRANSPOSE_LANES = 16 / sizeof(wchar_t);
+#else
+const int TRANSPOSE_LANES = 4;
+#endif
+
+
+static void TransposeBlockScalar(const wchar_t* columns, int rows, wchar_t* screen, int screenWidth,
+	int firstColumn, int columnCount, int firstRow, int rowCount)
+{
+	for (int y = firstRow; y < firstRow + rowCount; y++)
+	{
+		wchar_t* row = screen + y * screenWidth;
+		const wchar_t* cell = columns + firstColumn * rows + y;
+		for (int x = firstColumn; x < firstColumn + columnCount; x++, cell += rows)
+			row[x] = *cell;
+	}
+}
+
+#ifdef TRANSPOSE_HAS_X86_SIMD
+
+// source points at the block's top left cell in the column-major buffer, target at the same cell on screen
+static void TransposeBlock32(const wchar_t* source, int rows, wchar_t* target, int screenWidth)
+{
+	__m128i c0 = _mm_loadu_si128((const __m128i*)(source));
+	__m128i c1 = _mm_loadu_si128((const __m128i*)(source + rows));
+	__m128i c2 = _mm_loadu_si128((const __m128i*)(source + rows * 2));
+	__m128i c3 = _mm_loadu_si128((const __m128i*)(source + rows * 3));
+
+	// pairs of columns interleaved row by row, then pairs of pairs give whole rows
+	__m128i r01a = _mm_unpacklo_epi32(c0, c1), r01b = _mm_unpacklo_epi32(c2, c3);
+	__m128i r23a = _mm_unpackhi_epi32(c0, c1), r23b = _mm_unpackhi_epi32(c2, c3);
+
+	_mm_storeu_si128((__m128i*)(target), _mm_unpacklo_epi64(r01a, r01b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth), _mm_unpackhi_epi64(r01a, r01b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth * 2), _mm_unpacklo_epi64(r23a, r23b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth * 3), _mm_unpackhi_epi64(r23a, r23b));
+}
+
+static void TransposeBlock16(const wchar_t* source, int rows, wchar_t* target, int screenWidth)
+{
+	__m128i c0 = _mm_loadu_si128((const __m128i*)(source));
+	__m128i c1 = _mm_loadu_si128((const __m128i*)(source + rows));
+	__m128i c2 = _mm_loadu_si128((const __m128i*)(source + rows * 2));
+	__m128i c3 = _mm_loadu_si128((const __m128i*)(source + rows * 3));
+	__m128i c4 = _mm_loadu_si128((const __m128i*)(source + rows * 4));
+	__m128i c5 = _mm_loadu_si128((const __m128i*)(source + rows * 5));
+	__m128i c6 = _mm_loadu_si128((const __m128i*)(source + rows * 6));
+	__m128i c7 = _mm_loadu_si128((const __m128i*)(source + rows * 7));
+
+	// same interleaving as the 32 bit block with one more round, 16 -> 32 -> 64 bit pieces
+	__m128i r0123a = _mm_unpacklo_epi16(c0, c1), r0123b = _mm_unpacklo_epi16(c2, c3);
+	__m128i r0123c = _mm_unpacklo_epi16(c4, c5), r0123d = _mm_unpacklo_epi16(c6, c7);
+	__m128i r4567a = _mm_unpackhi_epi16(c0, c1), r4567b = _mm_unpackhi_epi16(c2, c3);
+	__m128i r4567c = _mm_unpackhi_epi16(c4, c5), r4567d = _mm_unpackhi_epi16(c6, c7);
+
+	__m128i r01a = _mm_unpacklo_epi32(r0123a, r0123b), r01b = _mm_unpacklo_epi32(r0123c, r0123d);
+	__m128i r23a = _mm_unpackhi_epi32(r0123a, r0123b), r23b = _mm_unpackhi_epi32(r0123c, r0123d);
+	__m128i r45a = _mm_unpacklo_epi32(r4567a, r4567b), r45b = _mm_unpacklo_epi32(r4567c, r4567d);
+	__m128i r67a = _mm_unpackhi_epi32(r4567a, r4567b), r67b = _mm_unpackhi_epi32(r4567c, r4567d);
+
+	_mm_storeu_si128((__m128i*)(target), _mm_unpacklo_epi64(r01a, r01b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth), _mm_unpackhi_epi64(r01a, r01b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth * 2), _mm_unpacklo_epi64(r23a, r23b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth * 3), _mm_unpackhi_epi64(r23a, r23b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth * 4), _mm_unpacklo_epi64(r45a, r45b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth * 5), _mm_unpackhi_epi64(r45a, r45b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth * 6), _mm_unpacklo_epi64(r67a, r67b));
+	_mm_storeu_si128((__m128i*)(target + screenWidth * 7), _mm_unpackhi_epi64(r67a, r67b));
+}
+
+#endif
+
+void TransposeColumns(const wchar_t* columns, int rows, wchar_t* screen, int screenWidth, int firstColumn, int columnCount)
+{
+	int blockColumns = columnCount - columnCount % TRANSPOSE_LANES;
+	int blockRows = rows - rows % TRANSPOSE_LANES;
+
+#ifdef TRANSPOSE_HAS_X86_SIMD
+	for (int y = 0; y < blockRows; y += TRANSPOSE_LANES)
+	{
+		for (int x = firstColumn; x < firstColumn + blockColumns; x += TRANSPOSE_LANES)
+		{
+			const wchar_t* source = columns + x * rows + y;
+			wchar_t* target = screen + y * screenWidth + x;
+			if (sizeof(wchar_t) == 4)
+				TransposeBlock32(source, rows, target, screenWidth);
+			else
+				TransposeBlock16(source, rows, target, screenWidth);
+		}
+	}
+#else
+	TransposeBlockScalar(columns, rows, screen, screenWidth, firstColumn, blockColumns, 0, blockRows);
+#endif
+
+	// leftover right edge and bottom edge of the tile
+	TransposeBlockScalar(columns, rows, screen, screenWidth, firstColumn + blockColumns, columnCount - blockColumns, 0, rows);
+	TransposeBlockScalar(columns, rows, screen, screenWidth, firstColumn, blockColumns, blockRows, rows - blockRows);
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+// blits columns [firstColumn, firstColumn + columnCount) of a column-major buffer, rows cells per column,
+// into a row-major screen screenWidth cells wide, square blocks of one SIMD register per side at a time
+void TransposeColumns(const wchar_t* columns, int rows, wchar_t* screen, int screenWidth, int firstColumn, int columnCount);
\ No newline at end of file
@@ -1,44 +1,81 @@
 #pragma once
 
-struct Vector2n;
+#include <cmath>
+#include <cstddef>
+#include <functional>
 
-struct Vector2f
+// header only and constexpr so every operation inlines into the loop that uses it, no call per component
+template <typename T>
+struct Vector2
 {
-	float X;
-	float Y;
-
-	Vector2f();
-	Vector2f(float x, float y);
-	Vector2f(const Vector2n& other);
-
-	static const Vector2f	Add(const Vector2f& lhs, const Vector2f& rhs);
-	static const Vector2f	Subtract(const Vector2f& lhs, const Vector2f& rhs);
-	static const bool		Equals(const Vector2f& lhs, const Vector2f& rhs);
-
-	const Vector2f	operator+  (const Vector2f& other) const;
-	const Vector2f	operator-  (const Vector2f& other) const;
-	void			operator+= (const Vector2f& other);
-	void			operator-= (const Vector2f& other);
-	const bool		operator== (const Vector2f& other) const;
+	T X;
+	T Y;
+
+	constexpr Vector2() : X(), Y() {}
+	constexpr Vector2(T x, T y) : X(x), Y(y) {}
+	// explicit, float to int truncates like a cast would
+	template <typename U>
+	constexpr explicit Vector2(const Vector2<U>& other) : X(static_cast<T>(other.X)), Y(static_cast<T>(other.Y)) {}
+
+	constexpr Vector2 operator+ (const Vector2& other) const { return { X + other.X, Y + other.Y }; }
+	constexpr Vector2 operator- (const Vector2& other) const { return { X - other.X, Y - other.Y }; }
+	constexpr Vector2 operator- () const { return { -X, -Y }; }
+	constexpr Vector2 operator* (T scale) const { return { X * scale, Y * scale }; }
+	constexpr Vector2 operator/ (T scale) const { return { X / scale, Y / scale }; }
+
+	constexpr Vector2& operator+= (const Vector2& other) { X += other.X; Y += other.Y; return *this; }
+	constexpr Vector2& operator-= (const Vector2& other) { X -= other.X; Y -= other.Y; return *this; }
+	constexpr Vector2& operator*= (T scale) { X *= scale; Y *= scale; return *this; }
+	constexpr Vector2& operator/= (T scale) { X /= scale; Y /= scale; return *this; }
+
+	constexpr bool operator== (const Vector2& other) const { return X == other.X && Y == other.Y; }
+	constexpr bool operator!= (const Vector2& other) const { return !(*this == other); }
 };
 
-struct Vector2n
-{
-	int X;
-	int Y;
+using Vector2f = Vector2<float>;
+using Vector2n = Vector2<int>;
 
-	Vector2n();
-	Vector2n(int x, int y);
+template <typename T>
+constexpr Vector2<T> operator* (T scale, const Vector2<T>& vector) { return vector * scale; }
 
-	static const Vector2n	Abs(const Vector2n& vector);
+template <typename T>
+constexpr T Dot(const Vector2<T>& lhs, const Vector2<T>& rhs) { return lhs.X * rhs.X + lhs.Y * rhs.Y; }
 
-	static const Vector2n	Add(const Vector2n& lhs, const Vector2n& rhs);
-	static const Vector2n	Subtract(const Vector2n& lhs, const Vector2n& rhs);
-	static const bool		Equals(const Vector2n& lhs, const Vector2n& rhs);
+template <typename T>
+constexpr T LengthSquared(const Vector2<T>& vector) { return Dot(vector, vector); }
+
+// not constexpr, sqrt is not until C++26
+inline float Length(const Vector2f& vector) { return std::sqrt(LengthSquared(vector)); }
+
+template <typename T>
+constexpr Vector2<T> Abs(const Vector2<T>& vector) { return { vector.X < 0 ? -vector.X : vector.X, vector.Y < 0 ? -vector.Y : vector.Y }; }
+
+// for unordered containers keyed by cell
+namespace std
+{
+	template <typename T>
+	struct hash<Vector2<T>>
+	{
+		size_t operator() (const Vector2<T>& vector) const
+		{
+			const size_t x = hash<T>()(vector.X), y = hash<T>()(vector.Y);
+			return x ^ (y + (size_t)0x9E3779B97F4A7C15ull + (x << 6) + (x >> 2));
+		}
+	};
+}
 
-	const Vector2n	operator+  (const Vector2n& other) const;
-	const Vector2n	operator-  (const Vector2n& other) const;
-	void			operator+= (const Vector2n& other);
-	void			operator-= (const Vector2n& other);
-	const bool		operator== (const Vector2n& other) const;
-};
\ No newline at end of file
+// checked whenever the header compiles
+static_assert(Vector2n(1, 2) + Vector2n(3, 4) == Vector2n(4, 6), "");
+static_assert(Vector2n(1, 2) - Vector2n(3, 4) == Vector2n(-2, -2), "");
+static_assert(-Vector2n(1, -2) == Vector2n(-1, 2), "");
+static_assert(Vector2n(1, 2) * 3 == Vector2n(3, 6) && 3 * Vector2n(1, 2) == Vector2n(3, 6), "");
+static_assert(Vector2n(6, 9) / 3 == Vector2n(2, 3), "");
+static_assert((Vector2n(1, 2) += Vector2n(1, 1)) == Vector2n(2, 3), "");
+static_assert((Vector2n(1, 2) -= Vector2n(1, 1)) == Vector2n(0, 1), "");
+static_assert(Vector2n(1, 2) != Vector2n(2, 1), "");
+static_assert(Dot(Vector2n(1, 2), Vector2n(3, 4)) == 11 && LengthSquared(Vector2n(3, 4)) == 25, "");
+static_assert(Abs(Vector2n(-3, 4)) == Vector2n(3, 4), "");
+// each component goes to its own component
+static_assert(Vector2f(Vector2n(1, 2)) == Vector2f(1.0f, 2.0f), "");
+static_assert(Vector2n(Vector2f(1.75f, -2.5f)) == Vector2n(1, -2), "");
+static_assert(Vector2f(0.5f, 1.0f) * 2.0f == Vector2f(1.0f, 2.0f), "");
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "WalkerSimulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "MathUtils.h"
+
+// this close to the middle of the cell it heads for, a walker picks the next one
+const float ARRIVE_DISTANCE = 0.1f;
+// a walker only walks while it faces its target about this closely, so it never cuts a corner into a wall
+const float WALK_MAX_TURN = 0.3f;
+// and stops turning once it faces it this closely, closer than that would only swing it back and forth
+const float TURN_DEAD_ZONE = 0.05f;
+
+static bool IsOpenCell(const OccupancyView& map, const int x, const int y)
+{
+	return map.Contains(x, y) && !map.IsWall(x, y);
+}
+
+
+WalkerSimulation::WalkerSimulation(const GameWorld& world, ThreadPool& pool, const float timeStep)
+	:	_world(world), _pool(pool), TIME_STEP(timeStep), _tickCount(0),
+		_posX(), _posY(), _angles(), _targetX(), _targetY(), _headings(), _hands(), _policies(), _randomStates(), _startTicks(), _hasExited(),
+		_inputs(), _distances(), _batchExitTicks()
+{}
+
+WalkerSimulation::~WalkerSimulation() {}
+
+void WalkerSimulation::AddWalkers(const int count, const WalkerPolicy policy, const unsigned int seed)
+{
+	const int first = GetWalkerCount();
+	const int walkerCount = first + count;
+
+	_posX.resize(walkerCount);
+	_posY.resize(walkerCount);
+	_angles.resize(walkerCount);
+	_targetX.resize(walkerCount);
+	_targetY.resize(walkerCount);
+	_headings.resize(walkerCount);
+	_hands.resize(walkerCount);
+	_policies.resize(walkerCount, policy);
+	_randomStates.resize(walkerCount);
+	_startTicks.resize(walkerCount);
+	_hasExited.resize(walkerCount, 0);
+	_inputs.resize(walkerCount);
+	_distances.resize(walkerCount);
+
+	for (int i = first; i < walkerCount; i++)
+	{
+		_randomStates[i] = ToRandomState(HashSeed(seed, (unsigned int)(i - first)));
+		_Respawn(i, _tickCount);
+	}
+
+	const int batchCount = (walkerCount + BATCH_SIZE - 1) / BATCH_SIZE;
+	for (auto& exitTicks : _batchExitTicks)
+		exitTicks.resize(batchCount);
+}
+
+void WalkerSimulation::Step()
+{
+	const int batchCount = (GetWalkerCount() + BATCH_SIZE - 1) / BATCH_SIZE;
+	WalkerSimulation* simulation = this;
+	_pool.ParallelFor(batchCount, [simulation](int batch) { simulation->_StepBatch(batch); });
+
+	_tickCount++;
+}
+
+int WalkerSimulation::GetWalkerCount() const { return (int)_posX.size(); }
+
+long long WalkerSimulation::GetTickCount() const { return _tickCount; }
+
+std::vector<int> WalkerSimulation::GetExitTicks(const WalkerPolicy policy) const
+{
+	std::vector<int> exitTicks;
+	for (const auto& batchExitTicks : _batchExitTicks[(int)policy])
+		exitTicks.insert(exitTicks.end(), batchExitTicks.begin(), batchExitTicks.end());
+	return exitTicks;
+}
+
+int WalkerSimulation::GetUnfinishedCount(const WalkerPolicy policy) const
+{
+	int count = 0;
+	for (int i = 0; i < GetWalkerCount(); i++)
+		count += _policies[i] == policy && !_hasExited[i];
+	return count;
+}
+
+// back at the start facing where a new player faces, heading for the start cell itself, so the next tick picks a way out
+void WalkerSimulation::_Respawn(const int walker, const long long startTick)
+{
+	PlayerState player;
+	PlayerInit(_world, player);
+
+	_posX[walker] = player.Pos.X;
+	_posY[walker] = player.Pos.Y;
+	_angles[walker] = player.Angle;
+	_targetX[walker] = _world.StartPos.X;
+	_targetY[walker] = _world.StartPos.Y;
+	_headings[walker] = (unsigned char)FlowStep::NegativeY;
+	_hands[walker] = NextRandom(_randomStates[walker]) & 1 ? 1 : 3;
+	_startTicks[walker] = startTick;
+}
+
+void WalkerSimulation::_StepBatch(const int batch)
+{
+	const OccupancyView& map = _world.Map;
+	const int first = batch * BATCH_SIZE;
+	const int last = std::min(first + BATCH_SIZE, GetWalkerCount());
+
+	// the keys every walker presses this tick
+	for (int i = first; i < last; i++)
+	{
+		float toTargetX = _targetX[i] + 0.5f - _posX[i], toTargetY = _targetY[i] + 0.5f - _posY[i];
+		if (toTargetX * toTargetX + toTargetY * toTargetY < ARRIVE_DISTANCE * ARRIVE_DISTANCE)
+		{
+			const int x = _targetX[i], y = _targetY[i], heading = _headings[i];
+			// a dead end, the only way on is back
+			int next = (heading + 2) & 3;
+
+			if (_policies[i] == WalkerPolicy::WallFollower)
+			{
+				// hand on the wall: towards it, straight on, away from it
+				const int TURNS[3] = { _hands[i], 0, 4 - _hands[i] };
+				for (int turn : TURNS)
+					if (IsOpenCell(map, x + STEP_X[(heading + turn) & 3], y + STEP_Y[(heading + turn) & 3]))
+					{
+						next = (heading + turn) & 3;
+						break;
+					}
+			}
+			else
+			{
+				int openDirections[3];
+				int openCount = 0;
+				for (int turn = -1; turn <= 1; turn++)
+					if (IsOpenCell(map, x + STEP_X[(heading + turn) & 3], y + STEP_Y[(heading + turn) & 3]))
+						openDirections[openCount++] = (heading + turn) & 3;
+
+				if (openCount > 0)
+					next = openDirections[NextRandom(_randomStates[i]) % openCount];
+			}
+
+			_headings[i] = (unsigned char)next;
+			_targetX[i] = x + STEP_X[next];
+			_targetY[i] = y + STEP_Y[next];
+			toTargetX = _targetX[i] + 0.5f - _posX[i];
+			toTargetY = _targetY[i] + 0.5f - _posY[i];
+		}
+
+		float turn = fmodf(atan2f(toTargetY, toTargetX) - _angles[i], PI * 2);
+		if (turn > PI)
+			turn -= PI * 2;
+		else if (turn < -PI)
+			turn += PI * 2;
+
+		InputState& input = _inputs[i];
+		input = {};
+		input.RotateRight = turn > TURN_DEAD_ZONE;
+		input.RotateLeft = turn < -TURN_DEAD_ZONE;
+		input.MoveForwards = fabsf(turn) < WALK_MAX_TURN;
+	}
+
+	MoveWalkers(map, &_inputs[first], last - first, TIME_STEP, &_posX[first], &_posY[first], &_angles[first]);
+	GetDistancesToEnd(_world, &_posX[first], &_posY[first], last - first, &_distances[first]);
+
+	for (int i = first; i < last; i++)
+	{
+		if (_distances[i] > 0.0f)
+			continue;
+
+		_batchExitTicks[(int)_policies[i]][batch].push_back((int)(_tickCount + 1 - _startTicks[i]));
+		_hasExited[i] = 1;
+		_Respawn(i, _tickCount + 1);
+	}
+}
\ No newline at end of file
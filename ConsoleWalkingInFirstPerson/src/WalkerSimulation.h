@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include "Game.h"
+#include "ThreadPool.h"
+
+enum class WalkerPolicy : unsigned char { WallFollower, RandomWalk };
+const int WALKER_POLICY_COUNT = 2;
+
+// bots walking a maze by pressing the same keys a player would, through the same movement, collision and
+// progress code, with nothing rendered
+// every field of every walker is an array of its own, a tick steps them in batches of BATCH_SIZE, one pool task each,
+// a walker only ever reads its own fields so the run is the same whatever the thread count
+class WalkerSimulation
+{
+public:
+	static const int BATCH_SIZE = 1024;
+
+	// the world is only read and has to outlive the simulation
+	WalkerSimulation(const GameWorld& world, ThreadPool& pool, const float timeStep);
+	~WalkerSimulation();
+
+	WalkerSimulation(const WalkerSimulation&) = delete;
+	WalkerSimulation& operator=(const WalkerSimulation&) = delete;
+
+	// count more walkers at the world's start, walkers of one seed and policy always take the same way
+	void AddWalkers(const int count, const WalkerPolicy policy, const unsigned int seed);
+	// one tick of every walker, a walker that reaches the exit starts over
+	void Step();
+
+	int GetWalkerCount() const;
+	long long GetTickCount() const;
+	// ticks from the start to the exit of every finished walk, in no particular order
+	std::vector<int> GetExitTicks(const WalkerPolicy policy) const;
+	// walkers of policy that have not found the exit even once
+	int GetUnfinishedCount(const WalkerPolicy policy) const;
+
+private:
+	const GameWorld& _world;
+	ThreadPool& _pool;
+	const float TIME_STEP;
+	long long _tickCount;
+
+	std::vector<float> _posX;
+	std::vector<float> _posY;
+	std::vector<float> _angles;
+	// map cell a walker is heading for and the direction it went to get there, a FlowStep
+	std::vector<int> _targetX;
+	std::vector<int> _targetY;
+	std::vector<unsigned char> _headings;
+	// the turn a wall follower tries first, 1 - right hand on the wall, 3 - left, picked anew every walk
+	std::vector<unsigned char> _hands;
+	std::vector<WalkerPolicy> _policies;
+	std::vector<unsigned int> _randomStates;
+	std::vector<long long> _startTicks;
+	std::vector<unsigned char> _hasExited;
+
+	// per tick scratch
+	std::vector<InputState> _inputs;
+	std::vector<float> _distances;
+
+	// finished walks, one list per batch so tasks never share one
+	std::vector<std::vector<int>> _batchExitTicks[WALKER_POLICY_COUNT];
+
+	// startTick is the first tick the walker steps in
+	void _Respawn(const int walker, const long long startTick);
+	void _StepBatch(const int batch);
+};
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "WindowsTerminal.h"
+
+#ifdef _WIN32
+
+WindowsTerminal::WindowsTerminal(const int width, const int height)
+	:	WIDTH(width), HEIGHT(height), _consoleHandle()
+{
+	_consoleHandle = CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE, 0, NULL, CONSOLE_TEXTMODE_BUFFER, NULL);
+	SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), ENABLE_EXTENDED_FLAGS);
+
+	// set console font
+	CONSOLE_FONT_INFOEX fontex;
+	fontex.cbSize = sizeof(CONSOLE_FONT_INFOEX);
+	GetCurrentConsoleFontEx(_consoleHandle, 0, &fontex);
+	fontex.dwFontSize.Y = 16;
+	SetCurrentConsoleFontEx(_consoleHandle, NULL, &fontex);
+
+	SetConsoleActiveScreenBuffer(_consoleHandle);
+}
+
+WindowsTerminal::~WindowsTerminal() {}
+
+void WindowsTerminal::Present(const wchar_t* screen)
+{
+	DWORD _;
+	WriteConsoleOutputCharacter(_consoleHandle, screen, WIDTH * HEIGHT, { 0, 0 }, &_);
+}
+
+std::unique_ptr<Terminal> CreatePlatformTerminal(const int width, const int height)
+{
+	return std::unique_ptr<Terminal>(new WindowsTerminal(width, height));
+}
+
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+#ifdef _WIN32
+
+#include <Windows.h>
+
+#include "Terminal.h"
+
+class WindowsTerminal : public Terminal
+{
+public:
+	WindowsTerminal(const int width, const int height);
+	~WindowsTerminal();
+
+	void Present(const wchar_t* screen) override;
+
+private:
+	int WIDTH, HEIGHT;
+	HANDLE _consoleHandle;
+};
+
+#endif
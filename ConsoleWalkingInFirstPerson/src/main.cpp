@@ -1,391 +1,447 @@
-#include <Windows.h>
 #include <string>
 #include <string.h>
-#include <sstream>
 #include <chrono>
-#include <algorithm>
-#include <iostream>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <memory>
 
 #include "Vector2.h"
 #include "Maze.h"
+#include "MazeFile.h"
+#include "MazePool.h"
+#include "Game.h"
+#include "InputTrace.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "Terminal.h"
+#include "Profiler.h"
+#include "Input.h"
+#include "FramePacer.h"
+#include "FramePresenter.h"
+#include "ResolutionScaler.h"
+#include "GameServer.h"
 
 
-const float PI = 3.14159f;
+// 0 - no cap
+const int DEFAULT_TARGET_FPS = 60;
 
-const Vector2n SCREEN_DIMENSIONS { 120, 40 };
-const Vector2n MAZE_DIMENSIONS { 6, 6 };
+// lowest share of the columns the frame budget may cut the ray count down to
+const float MIN_RESOLUTION_FRACTION = 0.25f;
 
-const float MAX_RENDERING_DISTANCE = 16.0f;
+// mazes generated ahead of the one being played
+const int MAZE_POOL_CAPACITY = 2;
 
-const float PLAYER_WALK_SPEED = 3.0f;
-const float PLAYER_ROTATION_SPEED = 1.6f;
 
-
-Vector2f _playerPos;
-float _playerAngle;
-float _playerFOV;
-
-bool _wantToPlay; 
-bool _gameOver;
-bool _mapIsVisible;
-bool _inDebug;
-
-
-static bool WorldPosHasWall(const std::wstring& map, const Vector2n& mapDimensions, const Vector2f& worldPos)
-{
-	Vector2n mapPosToCheck { (int)worldPos.X, (int)worldPos.Y };
-	if (0 <= mapPosToCheck.X && mapPosToCheck.X < mapDimensions.X && 
-		0 <= mapPosToCheck.Y && mapPosToCheck.Y < mapDimensions.Y)
-		return map[mapPosToCheck.Y * mapDimensions.X + mapPosToCheck.X] == '#';
-	else
-		return false;
-}
-
-static void HandleMenuInput()
-{
-	while (!(GetAsyncKeyState(VK_RETURN) & 0x0001)) {}
-}
-
-static void HandleInput(const std::wstring& map, const Vector2n& mapDimensions, float elapsedTime)
-{
-	float walkAmount = PLAYER_WALK_SPEED * elapsedTime;
-
-	Vector2f playerLookDir { cosf(_playerAngle), sinf(_playerAngle) };
-	Vector2f forwardsMoveAmount { playerLookDir.X * walkAmount, playerLookDir.Y * walkAmount };
-
-	Vector2f playerRightDir { cosf(_playerAngle + PI / 2), sinf(_playerAngle + PI / 2) };
-	Vector2f sidewaysMoveAmount { playerRightDir.X * walkAmount, playerRightDir.Y * walkAmount };
-
-	Vector2f playerNewPos = _playerPos;
-
-	if (GetAsyncKeyState((unsigned short)'W') & 0x8000)
-		playerNewPos += forwardsMoveAmount;
-	if (GetAsyncKeyState((unsigned short)'S') & 0x8000)
-		playerNewPos -= forwardsMoveAmount;
-
-	if (GetAsyncKeyState((unsigned short)'D') & 0x8000)
-		playerNewPos += sidewaysMoveAmount;
-	if (GetAsyncKeyState((unsigned short)'A') & 0x8000)
-		playerNewPos -= sidewaysMoveAmount;
-
-	if (!WorldPosHasWall(map, mapDimensions, playerNewPos))
-		_playerPos = playerNewPos;
-
-
-	float rotationAmount = PLAYER_ROTATION_SPEED * elapsedTime;
-
-	if (GetAsyncKeyState(VK_LEFT))
-		_playerAngle -= rotationAmount;
-	if (GetAsyncKeyState(VK_RIGHT))
-		_playerAngle += rotationAmount;
-
-	_playerAngle = fmod(_playerAngle, PI * 2);
-
-	if (GetAsyncKeyState((unsigned short)'M') & 0x0001)
-		_mapIsVisible = !_mapIsVisible;
-	if (GetAsyncKeyState(VK_DELETE) & 0x0001)
-		_inDebug = !_inDebug;
-}
-
-static bool HandleGameOverInput()
+// true for enter, false when the player quits, Escape is also what closed input reads as
+static bool WaitForEnterOrEscape(InputReader& input)
 {
+	input.DiscardEvents();
 	while (true)
 	{
-		// VK_RETURN is 'enter' key
-		if (GetAsyncKeyState(VK_RETURN) & 0x0001)
+		Key key = input.WaitForKeyDown();
+		if (key == Key::Enter)
 			return true;
-		else if (GetAsyncKeyState(VK_ESCAPE) & 0x0001)
+		else if (key == Key::Escape)
 			return false;
 	}
 }
 
-static float GetDistanceToWall(const std::wstring& map, const Vector2n& mapDimensions, const Vector2f& worldPos, float angle)
+// streams an Eller's maze of any height to a text file without holding the map, returns the process exit code
+static int GenerateMazeFile(const int width, const int height, const char* path)
 {
-	const float RAY_STEP_VALUE = 0.1f;
-
-	Vector2f lookDir { cosf(angle), sinf(angle) };
-	float raycastDistance = 0.0f;
-
-	while (raycastDistance < MAX_RENDERING_DISTANCE)
+	FILE* file = fopen(path, "w");
+	if (!file)
 	{
-		raycastDistance += RAY_STEP_VALUE;
+		fprintf(stderr, "could not open %s\n", path);
+		return 2;
+	}
 
-		Vector2f pointToCheckForWall
-		{
-			lookDir.X * raycastDistance + worldPos.X,
-			lookDir.Y * raycastDistance + worldPos.Y
-		};
+	srand(time(NULL));
+	Maze maze;
+	TextFileRowSink sink(file);
+	bool written = maze.GenerateRows(width, height, sink);
+	written = fclose(file) == 0 && written;
 
-		if (WorldPosHasWall(map, mapDimensions, pointToCheckForWall))
-			break;
+	if (!written)
+	{
+		fprintf(stderr, "could not write %s\n", path);
+		return 1;
 	}
-
-	return raycastDistance;
+	return 0;
 }
 
-static int GetScreenCeilingSizeFromDistanceToWall(float distanceToWall)
+// generates one maze with the chosen algorithm and saves it with its fields for --maze-file, returns the process exit code
+static int SaveMazeFile(const int width, const int height, const char* path, MazeAlgorithm algorithm, bool distanceField)
 {
-	float screenHalf = SCREEN_DIMENSIONS.Y / 2.0f;
-	int ceilingSize = static_cast<int>(screenHalf - screenHalf / distanceToWall);
-	return std::clamp<int>(ceilingSize, 0, static_cast<int>(screenHalf));
-}
+	srand(time(NULL));
+	Maze maze;
+	maze.SetAlgorithm(algorithm);
+	maze.SetDistanceFieldEnabled(distanceField);
+	if (algorithm == MazeAlgorithm::Tiled)
+	{
+		// the one maze big enough to be worth carving on every core
+		ThreadPool pool(0);
+		maze.GenerateTiled(width, height, (unsigned int)rand(), Maze::DEFAULT_TILE_SIZE, &pool);
+	}
+	else
+		maze.Generate(width, height);
 
-static wchar_t GetWallShadeFromDistance(float distance)
-{
-	if (distance <= MAX_RENDERING_DISTANCE / 4.0f)			return 0x2588;	// very close	
-	else if (distance < MAX_RENDERING_DISTANCE / 3.0f)		return 0x2593;
-	else if (distance < MAX_RENDERING_DISTANCE / 2.0f)		return 0x2592;
-	else if (distance < MAX_RENDERING_DISTANCE)				return 0x2591;
-	else													return ' ';		// very far away
+	if (!maze.Save(path))
+	{
+		fprintf(stderr, "could not write %s\n", path);
+		return 1;
+	}
+	return 0;
 }
 
-static wchar_t GetFloorShadeFromScreenY(int y)
-{
-	float screenHalf = SCREEN_DIMENSIONS.Y / 2.0f;
-	float highness = 1.0f - ((y - screenHalf) / screenHalf);
-	if (highness < 0.25)		return '#';
-	else if (highness < 0.5)	return 'x';
-	else if (highness < 0.75)	return '.';
-	else if (highness < 0.9)	return '-';
-	else						return ' ';
-}
+#ifndef _WIN32
+static GameServer* _runningServer = nullptr;
 
-static float GetNormalizedDistanceToEnd(const Vector2n& endPosition, const Vector2n& mapDimensions)
+static void StopServer(int)
 {
-	const Vector2n mapDimWithoutWalls { mapDimensions.X - 2, mapDimensions.Y - 2 };
-	const float maxDistance = abs(mapDimWithoutWalls.X) + abs(mapDimWithoutWalls.Y);
-
-	const Vector2n difference { abs(endPosition.X - (int)_playerPos.X), abs(endPosition.Y - (int)_playerPos.Y)};
-	return ((difference.X + difference.Y) / maxDistance);
+	_runningServer->Stop();
 }
+#endif
 
-
-static void WriteColumn(wchar_t* screen, const int x, const std::wstring& map, const Vector2n& mapDimensions)
+// every player who connects to socketPath walks the same maze until ctrl+c, returns the process exit code
+static int ServeGame(const char* socketPath, const MazeFile* mazeFile, const int threadCount, const int targetFps, const int renderColumns)
 {
-	float rayAngle = (_playerAngle - _playerFOV / 2.0f) + ((float)x / (float)SCREEN_DIMENSIONS.X) * _playerFOV;
-	float distanceToWall = GetDistanceToWall(map, mapDimensions, _playerPos, rayAngle);
-
-	unsigned int ceilingSize = GetScreenCeilingSizeFromDistanceToWall(distanceToWall);
-	unsigned int floorSize = SCREEN_DIMENSIONS.Y - ceilingSize;
-
-	// drawing from left top corner
-	for (size_t y = 0; y < SCREEN_DIMENSIONS.Y; y++)
+#ifdef _WIN32
+	fprintf(stderr, "the server needs unix sockets, it is not available on this platform\n");
+	return 2;
+#else
+	Maze maze;
+	GameWorld world;
+	if (mazeFile)
+		GameInitFromFile(*mazeFile, world);
+	else
 	{
-		size_t screenIndex = y * SCREEN_DIMENSIONS.X + x;
-
-		if (y <= ceilingSize)
-			screen[screenIndex] = ' ';
-		else if (y > ceilingSize && y <= floorSize)
-			screen[screenIndex] = GetWallShadeFromDistance(distanceToWall);
-		else
-			screen[screenIndex] = GetFloorShadeFromScreenY(y);
+		GenerateMaze(maze, SERVER_MAZE_DIMENSIONS, (unsigned int)rand());
+		GameInit(maze, world);
 	}
-}
-
-static void WriteProgressToEnd(wchar_t* screen, int screenYOffset, const float distanceToEnd)
-{
-	const wchar_t* message;
-	if (distanceToEnd < 0.05)
-		message = L"!!!!!!!!\0";
-	else if (0.05f  <= distanceToEnd && distanceToEnd < 0.125f)
-		message = L"########\0";
-	else if (0.125f <= distanceToEnd && distanceToEnd < 0.25f)
-		message = L"#######-\0";
-	else if (0.25f  <= distanceToEnd && distanceToEnd < 0.375f)
-		message = L"######--\0";
-	else if (0.375f <= distanceToEnd && distanceToEnd < 0.5f)
-		message = L"#####---\0";
-	else if (0.5f   <= distanceToEnd && distanceToEnd < 0.625f)
-		message = L"####----\0";
-	else if (0.625f <= distanceToEnd && distanceToEnd < 0.75f)
-		message = L"###-----\0";
-	else if (0.75f  <= distanceToEnd && distanceToEnd < 0.875f)
-		message = L"##------\0";
-	else if (0.875f <= distanceToEnd && distanceToEnd < 0.95f)
-		message = L"#-------\0";
-	else
-		message = L"--------\0";
-
-	for (size_t i = 0; i < wcslen(message); i++)
-		screen[screenYOffset * SCREEN_DIMENSIONS.X + i] = message[i];
-}
-
-static void WriteMap(wchar_t* screen, int screenYOffset, const std::wstring& map, const Vector2n& mapDimensions)
-{
-	for (size_t y = 0; y < mapDimensions.Y; y++)
-		for (size_t x = 0; x < mapDimensions.X; x++)
-			screen[(y + screenYOffset) * SCREEN_DIMENSIONS.X + x] = map[y * mapDimensions.X + x];
-	screen[((int)_playerPos.Y + screenYOffset) * SCREEN_DIMENSIONS.X + (int)_playerPos.X] = L'P';
-}
 
-static void WriteGameOver(wchar_t* screen)
-{
-	auto message = L"You won!";
-	for (size_t i = 0; i < wcslen(message); i++)
-		screen[i + SCREEN_DIMENSIONS.X * 0] = message[i];
+	ThreadPool pool(threadCount);
+	GameServer server(world, pool, targetFps, renderColumns);
+	if (!server.Listen(socketPath))
+	{
+		fprintf(stderr, "could not listen on %s\n", socketPath);
+		return 2;
+	}
 
-	message = L"If you want to try again press enter";
-	for (size_t i = 0; i < wcslen(message); i++)
-		screen[i + SCREEN_DIMENSIONS.X * 1] = message[i];
+	_runningServer = &server;
+	signal(SIGINT, StopServer);
+	signal(SIGTERM, StopServer);
 
-	message = L"If you want to exit press escape";
-	for (size_t i = 0; i < wcslen(message); i++)
-		screen[i + SCREEN_DIMENSIONS.X * 2] = message[i];
-}
+	printf("serving a %dx%d map on %s, ctrl+c stops\n", world.MapDimensions.X, world.MapDimensions.Y, socketPath);
+	printf("play with: socat -,raw,echo=0 UNIX-CONNECT:%s\n", socketPath);
+	server.Run();
 
-static void WriteDebugMessage(wchar_t* screen, int screenYOffset, float elapsedTime, float distanceToEnd)
-{
-	wchar_t message[45];
-	swprintf(message, 45, L"X=%3.2f, Y=%3.2f, A=%3.2f, DtE=%1.2f, FPS=%5.0f\0",
-		_playerPos.X, _playerPos.Y, _playerAngle, distanceToEnd, 1.0f / elapsedTime);
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+	_runningServer = nullptr;
 
-	for (size_t i = 0; i < wcslen(message); i++)
-		screen[screenYOffset * SCREEN_DIMENSIONS.X + i] = message[i];
+	GameServerStats stats = server.GetStats();
+	printf("%lld ticks, %.3f ms avg, %.3f ms max, %lld frames sent, %lld skipped, %lld bytes\n", stats.TickCount,
+		stats.TickCount > 0 ? stats.TotalTickMs / stats.TickCount : 0.0, stats.MaxTickMs, stats.FramesSent, stats.FramesSkipped, stats.BytesSent);
+	return 0;
+#endif
 }
 
-static void Print(wchar_t* screen, HANDLE consoleHandle)
+// hands the back buffer to the presenter, the game thread goes on with the next frame right away
+static void Print(FramePresenter& presenter, std::chrono::steady_clock::time_point frameStart)
 {
 	int screenSize = SCREEN_DIMENSIONS.X * SCREEN_DIMENSIONS.Y;
-	screen[screenSize - 1] = '\0';
+	presenter.GetBackBuffer()[screenSize - 1] = '\0';
 
-	DWORD _;
-	WriteConsoleOutputCharacter(consoleHandle, screen, screenSize, { 0, 0 }, &_);
+	presenter.Submit(frameStart);
 }
 
-static inline void WriteStartMenu(wchar_t* screen)
-{
-	auto message =
-		LR"(.__                            .___   __           .__                                                                  )"
-		LR"(|__|  __ __  ______  ____    __| _/ _/  |_  ____   |  |    ____ ___  __  ____     _____  _____   ________  ____    _____)"
-		LR"(|  | |  |  \/  ___/_/ __ \  / __ |  \   __\/  _ \  |  |   /  _ \\  \/ / / __ \   /     \ \__  \  \___   /_/ __ \  /  ___)"
-		LR"(|  | |  |  /\___ \ \  ___/ / /_/ |   |  | (  <_> ) |  |__(  <_> )\   / |  ___/  |  Y Y  \ / __ \_ /    / \  ___/  \___ \)"
-		LR"(|__| |____//____  > \___  >\____ |   |__|  \____/  |____/ \____/  \_/   \___  > |__|_|  /(____  //_____ \ \___  >/____  )"
-		LR"(                \/      \/      \/                                          \/        \/      \/       \/     \/      \/)"
-		LR"(                                                                                                                        )"
-		LR"(      ____ _  _ ____     __  ____ ____ ____ ____    ____ __ _ ____ ____ ____ __ __ _  ___    ____ _  _ __ ____          )"
-		LR"(     (  _ / )( (_  _)   / _\(  __(_  _(  __(  _ \  (  __(  ( (_  _(  __(  _ (  (  ( \/ __)  (_  _/ )( (  / ___)         )"
-		LR"(      ) _ ) \/ ( )(    /    \) _)  )(  ) _) )   /   ) _)/    / )(  ) _) )   /)(/    ( (_ \    )( ) __ ()(\___ \         )"
-		LR"(     (____\____/(__)   \_/\_(__)  (__)(____(__\_)  (____\_)__)(__)(____(__\_(__\_)__)\___/   (__)\_)(_(__(____/         )"
-		LR"(      __    __  ____ ____     __  __ _ ____      __ __  _    __ _  __ ____    ____  __     ____ _  _ ____ ____          )"
-		LR"(     (  )  / _\/ ___(_  _)   /  \(  ( (  __)_   (  (( \/ )  (  ( \/  (_  _)  / ___)/  \   / ___/ )( (  _ (  __)         )"
-		LR"(     / (_//    \___ \ )(    (  O /    /) _)( )   )( / \/ \  /    (  O ))(    \___ (  O )  \___ ) \/ ()   /) _)          )"
-		LR"(     \____\_/\_(____/(__)    \__/\_)__(____(/   (__)\_)(_/  \_)__)\__/(__)   (____/\__/   (____\____(__\_(____)         )"
-		LR"(      _  _ _  _ ____ ____ ____    __    ____ ____ __  __ _ ____     __  __ _ _  _ _  _  __ ____ ____                    )"
-		LR"(     / )( / )( (  __(  _ (  __)  (  )  / ___(_  _/ _\(  ( (    \   / _\(  ( ( \/ ( \/ )/  (  _ (  __)                   )"
-		LR"(     \ /\ ) __ () _) )   /) _)    )(   \___ \ )(/    /    /) D (  /    /    /)  // \/ (  O )   /) _) _                  )"
-		LR"(     (_/\_\_)(_(____(__\_(____)  (__)  (____/(__\_/\_\_)__(____/  \_/\_\_)__(__/ \_)(_/\__(__\_(____(_)                 )"
-		LR"(                                                                                                                        )"
-		LR"(                                                                                                                        )"
-		LR"(                                                    controls                                                            )"
-		LR"(                                    wasd - to move            arrows - to look                                          )"
-		LR"(                                                                                                                        )"
-		LR"(                                                                                                                        )"
-		LR"(                                               press enter to start                                                     )"
-		LR"(                                                                                                                        )"
-		LR"(                                                                                                                        )";
-
-	auto messageLength = wcslen(message);
-	auto screenSize = SCREEN_DIMENSIONS.X * SCREEN_DIMENSIONS.Y;
-	for (size_t i = 0; i < screenSize; i++)
-		screen[i] = i < messageLength ? message[i] : ' ';
-}
 
-
-static void ConsoleInit(wchar_t*& screen, HANDLE& consoleHandle)
-{
-	screen = new wchar_t[SCREEN_DIMENSIONS.X * SCREEN_DIMENSIONS.Y];
-	consoleHandle = CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE, 0, NULL, CONSOLE_TEXTMODE_BUFFER, NULL);
-	SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), ENABLE_EXTENDED_FLAGS);
-
-	// set console font
-	CONSOLE_FONT_INFOEX fontex;
-	fontex.cbSize = sizeof(CONSOLE_FONT_INFOEX);
-	GetCurrentConsoleFontEx(consoleHandle, 0, &fontex);
-	fontex.dwFontSize.Y = 16;
-	SetCurrentConsoleFontEx(consoleHandle, NULL, &fontex);
-
-	SetConsoleActiveScreenBuffer(consoleHandle);
-}
-
-static void GameMenu(wchar_t* screen, HANDLE consoleHandle)
+static void ConsoleInit(std::unique_ptr<Terminal>& terminal)
 {
-	WriteStartMenu(screen);
-	Print(screen, consoleHandle);
-	HandleMenuInput();
+	terminal = CreatePlatformTerminal(SCREEN_DIMENSIONS.X, SCREEN_DIMENSIONS.Y);
 }
 
-static void GameInit(Maze& maze, std::wstring& map, Vector2n& mapDim, Vector2n& endPos)
+static bool GameMenu(FramePresenter& presenter, InputReader& input)
 {
-	maze.Generate(MAZE_DIMENSIONS.X, MAZE_DIMENSIONS.Y);
-
-	_playerAngle = -PI / 2;
-	_playerFOV = PI / 4.0f;
-
-	_gameOver = false;
-	_mapIsVisible = false;
-	_inDebug = false;
-
-	_playerPos = Vector2f(maze.GetStartPos()) + Vector2f(0.5f, 0.5f);
-
-	map = maze.GetMap();
-	mapDim = { maze.GetMapWidth(), maze.GetMapHeight() };
-	endPos = maze.GetExitPos();
+	WriteStartMenu(presenter.GetBackBuffer());
+	Print(presenter, std::chrono::steady_clock::now());
+	return WaitForEnterOrEscape(input);
 }
 
-static void GameStart(wchar_t* screen, HANDLE consoleHandle)
+static void GameStart(FramePresenter& presenter, InputReader& inputReader, ThreadPool& renderPool,
+	FramePacer& pacer, ResolutionScaler& scaler, int renderColumns, bool infiniteWorld, const MazeFile* mazeFile, InputTraceRecorder* recorder)
 {
-	_wantToPlay = true;
-
+	bool wantToPlay = true;
 
 	auto lastFrameTime = std::chrono::steady_clock::now();
 	std::chrono::steady_clock::time_point thisFrameTime;
 
-	Maze maze;
-	const std::wstring map;
-	const Vector2n mapDim;
-	const Vector2n endPos;
-
-	while (_wantToPlay)
+	// each owns a generator thread, only one of them is started
+	std::unique_ptr<ChunkedWorld> chunks(infiniteWorld ? new ChunkedWorld() : nullptr);
+	std::unique_ptr<MazePool> mazePool(!infiniteWorld && !mazeFile
+		? new MazePool(MAZE_POOL_CAPACITY, (unsigned int)rand(), [](Maze& maze, unsigned int seed) { GenerateMaze(maze, MAZE_DIMENSIONS, seed); })
+		: nullptr);
+	std::unique_ptr<Maze> maze;
+	GameWorld world;
+	PlayerState player;
+	RenderBuffers renderBuffers;
+	renderBuffers.RenderColumns = renderColumns;
+
+	while (wantToPlay)
 	{
-		GameInit(maze, const_cast<std::wstring&>(map), const_cast<Vector2n&>(mapDim), const_cast<Vector2n&>(endPos));
+		if (chunks)
+			GameInitChunked(*chunks, (unsigned int)rand(), world);
+		else if (mazeFile)
+			GameInitFromFile(*mazeFile, world);
+		else
+		{
+			std::unique_ptr<Maze> nextMaze = mazePool->Pop();
+			GameInit(*nextMaze, world);
+			// the last maze is no longer read once the world points at the next one
+			mazePool->Recycle(std::move(maze));
+			maze = std::move(nextMaze);
+		}
+		PlayerInit(world, player);
+		bool gameOver = false;
 
-		while (!_gameOver)
+		while (!gameOver)
 		{
 			thisFrameTime = std::chrono::steady_clock::now();
 			std::chrono::duration<float> elapsedTime = thisFrameTime - lastFrameTime;
 			lastFrameTime = thisFrameTime;
 
-			HandleInput(map, mapDim, elapsedTime.count());
+			{
+				PROFILE_STAGE(FrameStage::Input);
+
+				InputState input = inputReader.ReadFrameInput();
+				if (recorder)
+					recorder->Record(input);
 
-			for (size_t x = 0; x < SCREEN_DIMENSIONS.X; x++)
-				WriteColumn(screen, x, map, mapDim);
+				HandleInput(world, player, input, elapsedTime.count());
+				if (chunks)
+					UpdateChunkedWorld(*chunks, world, player);
+			}
 
-			float distanceToEnd = GetNormalizedDistanceToEnd(endPos, mapDim);
-			_gameOver = distanceToEnd < 0.01f;
+			auto renderStart = std::chrono::steady_clock::now();
 
-			WriteProgressToEnd(screen, 0, distanceToEnd);
-			if (_mapIsVisible)
-				WriteMap(screen, 1, map, mapDim);
-			if (_inDebug)
-				WriteDebugMessage(screen, SCREEN_DIMENSIONS.Y - 1, elapsedTime.count(), distanceToEnd);
+			gameOver = WriteFrame(presenter.GetBackBuffer(), renderPool, renderBuffers, world, player, elapsedTime.count(), presenter.GetLatencyMs());
+			Print(presenter, thisFrameTime);
 
-			Print(screen, consoleHandle);
+			// presenting runs on its own thread and the pacer's sleep is not load, only rendering counts against the budget
+			if (renderColumns == 0)
+			{
+				std::chrono::duration<float, std::milli> renderTime = std::chrono::steady_clock::now() - renderStart;
+				renderBuffers.RenderColumns = scaler.Update(renderTime.count(), SCREEN_DIMENSIONS.X);
+			}
+
+			pacer.Wait();
+
+			// nobody is left to play, e.g. stdin was a pipe that ran out
+			if (inputReader.IsClosed())
+				return;
 		}
 
-		WriteGameOver(screen);
-		Print(screen, consoleHandle);
-		_wantToPlay = HandleGameOverInput();
+		// the message goes on top of the frame the player won on
+		presenter.CopyLastFrame();
+		WriteGameOver(presenter.GetBackBuffer());
+		Print(presenter, std::chrono::steady_clock::now());
+		wantToPlay = WaitForEnterOrEscape(inputReader);
+
+		// time spent on the game over screen is not a frame
+		lastFrameTime = std::chrono::steady_clock::now();
 	}
 }
 
 
-int main()
+int main(int argc, char* argv[])
 {
+	// 0 - one render thread per core
+	int renderThreadCount = 0;
+	int targetFps = DEFAULT_TARGET_FPS;
+	// 0 - no budget, every column gets a ray
+	float frameBudgetMs = 0.0f;
+	// 0 - picked by the frame budget
+	int renderColumns = 0;
+	const char* recordTracePath = nullptr;
+	const char* profileTracePath = nullptr;
+	// chunked endless world instead of a maze
+	bool infiniteWorld = false;
+	// pre-generated maze instead of a new one every game
+	const char* mazeFilePath = nullptr;
+	MazeAlgorithm mazeAlgorithm = MazeAlgorithm::DepthFirst;
+	bool distanceField = false;
+	// --save-maze, applied after every flag is read so --maze and --distance-field may come after it
+	Vector2n saveMazeDimensions { 0, 0 };
+	const char* saveMazePath = nullptr;
+
+	// --server, many players over unix sockets instead of one on this terminal
+	const char* serverSocketPath = nullptr;
+	bool runServerBenchmark = false;
+	bool runWalkerBenchmark = false;
+
+	bool runReplayBenchmark = false;
+	ReplayBenchmarkOptions replayOptions { 1, nullptr, nullptr, nullptr, 0, 0, false };
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--bench-raycast") == 0)
+		{
+			RunRaycastBenchmark();
+			return 0;
+		}
+		else if (strcmp(argv[i], "--bench-maze") == 0)
+		{
+			RunMazeBenchmark();
+			return 0;
+		}
+		else if (strcmp(argv[i], "--bench-maze-pool") == 0)
+		{
+			RunMazePoolBenchmark();
+			return 0;
+		}
+		else if (strcmp(argv[i], "--bench-chunks") == 0)
+		{
+			RunChunkBenchmark();
+			return 0;
+		}
+		else if (strcmp(argv[i], "--bench-replay") == 0)
+			runReplayBenchmark = true;
+		else if (strcmp(argv[i], "--bench-server") == 0)
+			runServerBenchmark = true;
+		else if (strcmp(argv[i], "--bench-walkers") == 0)
+			runWalkerBenchmark = true;
+		else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc)
+			serverSocketPath = argv[++i];
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			replayOptions.Seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+			replayOptions.TracePath = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+			replayOptions.BaselinePath = argv[++i];
+		else if (strcmp(argv[i], "--save-baseline") == 0 && i + 1 < argc)
+			replayOptions.SaveBaselinePath = argv[++i];
+		else if (strcmp(argv[i], "--record-trace") == 0 && i + 1 < argc)
+			recordTracePath = argv[++i];
+		else if (strcmp(argv[i], "--profile-trace") == 0 && i + 1 < argc)
+			profileTracePath = argv[++i];
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			renderThreadCount = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+			targetFps = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+		{
+			int width = 0, height = 0;
+			if (sscanf(argv[++i], "%dx%d", &width, &height) == 2)
+				SetScreenDimensions(width, height);
+		}
+		else if (strcmp(argv[i], "--frame-budget") == 0 && i + 1 < argc)
+			frameBudgetMs = (float)atof(argv[++i]);
+		else if (strcmp(argv[i], "--render-columns") == 0 && i + 1 < argc)
+			renderColumns = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--no-ray-reuse") == 0)
+			SetRayReuse(false);
+		else if (strcmp(argv[i], "--distance-field") == 0)
+		{
+			distanceField = true;
+			SetDistanceFieldRaycasting(true);
+		}
+		else if (strcmp(argv[i], "--infinite") == 0)
+			infiniteWorld = true;
+		else if (strcmp(argv[i], "--maze") == 0 && i + 1 < argc)
+		{
+			i++;
+			if (strcmp(argv[i], "eller") == 0)
+				mazeAlgorithm = MazeAlgorithm::Eller;
+			else if (strcmp(argv[i], "tiled") == 0)
+				mazeAlgorithm = MazeAlgorithm::Tiled;
+			else
+				mazeAlgorithm = MazeAlgorithm::DepthFirst;
+			SetMazeAlgorithm(mazeAlgorithm);
+		}
+		else if (strcmp(argv[i], "--maze-file") == 0 && i + 1 < argc)
+			mazeFilePath = argv[++i];
+		else if (strcmp(argv[i], "--bench-maze-file") == 0 && i + 1 < argc)
+			return RunMazeFileBenchmark(argv[++i]);
+		else if (strcmp(argv[i], "--save-maze") == 0 && i + 2 < argc)
+		{
+			if (sscanf(argv[++i], "%dx%d", &saveMazeDimensions.X, &saveMazeDimensions.Y) != 2
+				|| saveMazeDimensions.X < 2 || saveMazeDimensions.Y < 2)
+			{
+				fprintf(stderr, "maze size has to be WxH, at least 2x2\n");
+				return 2;
+			}
+			saveMazePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--generate-maze") == 0 && i + 2 < argc)
+		{
+			int width = 0, height = 0;
+			if (sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+			{
+				fprintf(stderr, "maze size has to be WxH\n");
+				return 2;
+			}
+			return GenerateMazeFile(width, height, argv[++i]);
+		}
+	}
+
+	if (saveMazePath)
+		return SaveMazeFile(saveMazeDimensions.X, saveMazeDimensions.Y, saveMazePath, mazeAlgorithm, distanceField);
+
+	if (runReplayBenchmark)
+	{
+		replayOptions.RenderThreadCount = renderThreadCount;
+		replayOptions.RenderColumns = renderColumns;
+		replayOptions.InfiniteWorld = infiniteWorld;
+		int exitCode = RunReplayBenchmark(replayOptions);
+		if (profileTracePath)
+			WriteChromeTrace(profileTracePath);
+		return exitCode;
+	}
+
+	if (runServerBenchmark)
+	{
+		RunServerBenchmark(renderThreadCount);
+		return 0;
+	}
+
+	if (runWalkerBenchmark)
+	{
+		RunWalkerBenchmark(renderThreadCount);
+		return 0;
+	}
+
 	srand(time(NULL));
 
-	wchar_t* screen = nullptr; HANDLE consoleHandle;
-	ConsoleInit(screen, consoleHandle);
+	// opened before the terminal so a bad file is reported on a normal console
+	MazeFile mazeFile;
+	if (mazeFilePath && !mazeFile.Open(mazeFilePath))
+	{
+		fprintf(stderr, "could not open maze file %s\n", mazeFilePath);
+		return 2;
+	}
 
-	GameMenu(screen, consoleHandle);
-	GameStart(screen, consoleHandle);
-}
\ No newline at end of file
+	if (serverSocketPath)
+		return ServeGame(serverSocketPath, mazeFile.IsOpen() ? &mazeFile : nullptr, renderThreadCount, targetFps, renderColumns);
+
+	std::unique_ptr<Terminal> terminal;
+	ConsoleInit(terminal);
+	// after the terminal, which puts a unix tty into raw mode, and gone before it restores the tty
+	FramePresenter presenter(*terminal, SCREEN_DIMENSIONS.X * SCREEN_DIMENSIONS.Y);
+	InputReader inputReader;
+	ThreadPool renderPool(renderThreadCount);
+	FramePacer pacer(targetFps);
+	ResolutionScaler scaler(frameBudgetMs, MIN_RESOLUTION_FRACTION);
+	InputTraceRecorder recorder;
+
+	if (GameMenu(presenter, inputReader))
+		GameStart(presenter, inputReader, renderPool, pacer, scaler, renderColumns, infiniteWorld, mazeFile.IsOpen() ? &mazeFile : nullptr, recordTracePath ? &recorder : nullptr);
+
+	if (recordTracePath)
+		SaveInputTrace(recordTracePath, recorder.GetTrace());
+	if (profileTracePath)
+		WriteChromeTrace(profileTracePath);
+}